@@ -0,0 +1 @@
+../src/cir/cirCut.h
\ No newline at end of file
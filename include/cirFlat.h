@@ -0,0 +1 @@
+../src/cir/cirFlat.h
\ No newline at end of file
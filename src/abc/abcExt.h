@@ -11,7 +11,7 @@ extern void initCirMgr(const int& piNum, const int& poNum, const int& regNum, co
  * @brief Extern functions under the circuit manager
  */
 extern bool inputIsPi(const int& gateId);
-extern void parseInput(const int& idx, const int& gateId);
+extern void parseInput(const int& idx, const int& gateId, std::string piName = "");
 extern void parseOutput(const int& idx, const int& gateId, const int& in0Id, const int& inv, std::string poName);
 extern void parseAig(const int& gateId, const int& in0Id, const int& in0Inv, const int& in1Id, const int& in1Inv);
 extern void parseRi(const int& idx, const int& gateId, const int& in0Id, const int& inv);
@@ -5,6 +5,7 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "abcExt.h"
 #include "base/abc/abc.h"
@@ -111,8 +112,10 @@ void AbcMgr::travAllObj(const FileType &fileType, map<unsigned, string> id2Name)
     Gia_ManForEachObj(pGia, pObj, i) {
         int gateId = Gia_ObjId(pGia, pObj);
         if (Gia_ObjIsPi(pGia, pObj)) {
-            if (inputIsPi(gateId)) parseInput(iPi++, gateId);
-            else parseRo(iRo++, gateId, AIGER);
+            if (inputIsPi(gateId)) {
+                string piName = (id2Name.count(gateId)) ? id2Name[gateId] : "";
+                parseInput(iPi++, gateId, piName);
+            } else parseRo(iRo++, gateId, AIGER);
         } else if (Gia_ObjIsPo(pGia, pObj)) {
             int in0Id     = Gia_ObjId(pGia, Gia_ObjFanin0(pObj));
             int inv       = Gia_ObjFaninC0(pObj);
@@ -272,9 +275,9 @@ void AbcMgr::cirToAig(IDMap &aigIdMap) {
 
 void AbcMgr::writeBlif(const string &fileName) {
     Abc_Ntk_t *pNtkTemp = Abc_NtkToNetlist(pNtk);
-    char *pFileName     = new char[100];
-    strcpy(pFileName, fileName.c_str());
-    Io_WriteBlif(pNtkTemp, pFileName, 1, 0, 1);
+    vector<char> pFileName(fileName.c_str(), fileName.c_str() + fileName.size() + 1);
+    Io_WriteBlif(pNtkTemp, pFileName.data(), 1, 0, 1);
+    Abc_NtkDelete(pNtkTemp);
 }
 
 void AbcMgr::runPDR(const bool &verbose) {
@@ -43,6 +43,7 @@ bool initBddCmd() {
             gvCmdMgr->regCmd("BDRAW", 5, new BDrawCmd) &&
             gvCmdMgr->regCmd("BSETOrder", 5, new BSetOrderCmd) &&
             gvCmdMgr->regCmd("BCONstruct", 4, new BConstructCmd) &&
+            gvCmdMgr->regCmd("BSTATs", 5, new BStatsCmd) &&
 
 
             gvCmdMgr->regCmd("FSETVar", 5, new FSetVarCmd) &&
@@ -989,10 +990,9 @@ void FCompareCmd::help() const {
 }
 
 //----------------------------------------------------------------------
-//    BSIMulate <(string bddName)> <(bit_string inputPattern)>
+//    BSIMulate <(string bddName)> <(bit_string inputPattern) |
+//              -File <(string patternFile)> [-Output <(string logFile)>]>
 //----------------------------------------------------------------------
-// input pattern = [01]*
-//
 GVCmdExecStatus
 BSimulateCmd::exec(const string& option) {
     // check option
@@ -1000,8 +1000,6 @@ BSimulateCmd::exec(const string& option) {
     GVCmdExec::lexOptions(option, options);
     if (options.size() < 2) {
         return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, "");
-    } else if (options.size() > 2) {
-        return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[2]);
     }
 
     if (!isValidBddName(options[0]))
@@ -1010,19 +1008,50 @@ BSimulateCmd::exec(const string& option) {
     if (node() == 0)
         return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[0]);
 
-    int value = bddMgrV->evalCube(node, options[1]);
-    if (value == -1)
-        return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[1]);
+    if (myStrNCmp("-File", options[1], 2)) {
+        if (options.size() > 2)
+            return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[2]);
+
+        int value = bddMgrV->evalCube(node, options[1]);
+        if (value == -1)
+            return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[1]);
 
-    cout << "BDD Simulate: " << options[1] << " = " << value << endl;
+        cout << "BDD Simulate: " << options[1] << " = " << value << endl;
+        return GV_CMD_EXEC_DONE;
+    }
+
+    // bit-parallel simulation of the patterns in a file
+    if (options.size() < 3)
+        return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[1]);
+    ifstream patternFile(options[2].c_str(), ios::in);
+    if (!patternFile)
+        return GVCmdExec::errorOption(GV_CMD_OPT_FOPEN_FAIL, options[2]);
+    ofstream logFile;
+    if (options.size() > 3) {
+        if (myStrNCmp("-Output", options[3], 2))
+            return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[3]);
+        if (options.size() < 5)
+            return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[3]);
+        if (options.size() > 5)
+            return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[5]);
+        logFile.open(options[4].c_str(), ios::out);
+        if (!logFile)
+            return GVCmdExec::errorOption(GV_CMD_OPT_FOPEN_FAIL, options[4]);
+    }
+
+    if (!bddMgrV->evalPatternFile(node, patternFile,
+                                  logFile.is_open() ? &logFile : 0))
+        return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[2]);
 
     return GV_CMD_EXEC_DONE;
 }
 
 void BSimulateCmd::usage(const bool& verbose) const {
     cout
-        << "Usage: BSIMulate <(string bddName)> <(bit_string inputPattern)>"
-        << endl;
+        << "Usage: BSIMulate <(string bddName)> <(bit_string inputPattern) |"
+        << endl
+        << "                 -File <(string patternFile)> "
+        << "[-Output <(string logFile)>]>" << endl;
 }
 
 void BSimulateCmd::help() const {
@@ -1349,6 +1378,39 @@ void BConstructCmd::help() const {
          << "Build BDD From Current Design." << endl;
 }
 
+//----------------------------------------------------------------------
+//    BSTATs [-Level] [-Chain] [-Reset]
+//----------------------------------------------------------------------
+GVCmdExecStatus
+BStatsCmd::exec(const string& option) {
+    // check option
+    vector<string> options;
+    GVCmdExec::lexOptions(option, options);
+
+    bool doLevel = false, doChain = false, doReset = false;
+    for (size_t i = 0, n = options.size(); i < n; ++i) {
+        if (!myStrNCmp("-Level", options[i], 2)) doLevel = true;
+        else if (!myStrNCmp("-Chain", options[i], 2)) doChain = true;
+        else if (!myStrNCmp("-Reset", options[i], 2)) doReset = true;
+        else return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+    }
+
+    assert(bddMgrV != 0);
+    if (doReset) bddMgrV->resetStats();
+    else bddMgrV->printStats(doLevel, doChain);
+
+    return GV_CMD_EXEC_DONE;
+}
+
+void BStatsCmd::usage(const bool& verbose) const {
+    cout << "Usage: BSTATs [-Level] [-Chain] [-Reset]" << endl;
+}
+
+void BStatsCmd::help() const {
+    cout << setw(20) << left << "BSTATs: "
+         << "Report BDD package statistics" << endl;
+}
+
 
 
 //----------------------------------------------------------------------
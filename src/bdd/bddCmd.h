@@ -31,6 +31,7 @@ GV_COMMAND(BReportCmd, GV_CMD_TYPE_BDD);
 GV_COMMAND(BDrawCmd, GV_CMD_TYPE_BDD);
 GV_COMMAND(BSetOrderCmd, GV_CMD_TYPE_BDD);
 GV_COMMAND(BConstructCmd, GV_CMD_TYPE_BDD);
+GV_COMMAND(BStatsCmd, GV_CMD_TYPE_BDD);
 
 GV_COMMAND(FSetVarCmd, GV_CMD_TYPE_BDD);
 GV_COMMAND(FInvCmd, GV_CMD_TYPE_BDD);
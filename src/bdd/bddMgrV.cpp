@@ -21,7 +21,7 @@ using namespace std;
 //----------------------------------------------------------------------
 //    Global variables
 //----------------------------------------------------------------------
-BddMgrV* bddMgrV = 0;  // new BddMgrV;
+thread_local BddMgrV* bddMgrV = 0;  // new BddMgrV;
 
 //----------------------------------------------------------------------
 //    External functions
@@ -68,20 +68,16 @@ FddNodeV getFddNodeV(const string& bddName) {
 //
 void BddMgrV::init(size_t nin, size_t h, size_t c) {
     reset();
+    resetStats();
    _uniqueTable.init(h);
    _fdduniqueTable.init(h);
    _computedTable.init(c);
+   _binCache.init(c);
    _fddcomputedTable.init(c);
 
     // This must be called first
-    BddNodeV::setBddMgrV(this);
-    FddNodeV::setBddMgrV(this);
-    BddNodeVInt::_terminal = uniquify(0, 0, 0);
-    FddNodeVInt::_terminal = fdduniquify(0, 0, 0);
-    BddNodeV::_one         = BddNodeV(BddNodeVInt::_terminal, BDD_POS_EDGEV);
-    BddNodeV::_zero        = BddNodeV(BddNodeVInt::_terminal, BDD_NEG_EDGEV);
-    FddNodeV::_one         = FddNodeV(FddNodeVInt::_terminal, FDD_POS_EDGE);
-    FddNodeV::_zero        = FddNodeV(FddNodeVInt::_terminal, FDD_NEG_EDGE);
+    // [Note] The terminal node (_one/_zero) is shared by all managers
+    activate();
 
     _supports.reserve(nin + 1);
     _supports.push_back(BddNodeV::_one);
@@ -93,6 +89,19 @@ void BddMgrV::init(size_t nin, size_t h, size_t c) {
     }
 }
 
+BddMgrV::~BddMgrV() {
+    reset();
+    if (bddMgrV == this) bddMgrV = 0;
+    if (BddNodeV::getBddMgrV() == this) BddNodeV::setBddMgrV(0);
+    if (FddNodeV::getBddMgrV() == this) FddNodeV::setBddMgrV(0);
+}
+
+void BddMgrV::activate() {
+    bddMgrV = this;
+    BddNodeV::setBddMgrV(this);
+    FddNodeV::setBddMgrV(this);
+}
+
 // Called by the BSETOrder command
 void BddMgrV::restart() {
     size_t nin = _supports.size() - 1;
@@ -110,16 +119,23 @@ void BddMgrV::reset() {
     _fddArr.clear();
     _bddMap.clear();
     _fddMap.clear();
+    // Release the children first so that no deleted node is dereferenced
     BddHash::iterator bi = _uniqueTable.begin();
     for (; bi != _uniqueTable.end(); ++bi)
+        (*bi).second->_left = (*bi).second->_right = BddNodeV();
+    for (bi = _uniqueTable.begin(); bi != _uniqueTable.end(); ++bi)
         delete (*bi).second;
     FddHash::iterator fi = _fdduniqueTable.begin();
     for (; fi != _fdduniqueTable.end(); ++fi)
+        (*fi).second->_left = (*fi).second->_right = FddNodeV();
+    for (fi = _fdduniqueTable.begin(); fi != _fdduniqueTable.end(); ++fi)
         delete (*fi).second;
     _uniqueTable.reset();
     _fdduniqueTable.reset();
     _computedTable.reset();
+    _binCache.reset();
     _fddcomputedTable.reset();
+    _numNodes = 0;
 }
 
 // [Note] Remeber to check "isNegEdge" when return BddNodeV!!!!!
@@ -127,6 +143,7 @@ void BddMgrV::reset() {
 BddNodeV
 BddMgrV::ite(BddNodeV f, BddNodeV g, BddNodeV h) {
     bool isNegEdge = false;  // should only be flipped by "standardize()"
+    ++_numIteCalls;
 
 #define DO_STD_ITE 1  // NOTE: make it '0' if you haven't done standardize()!!
     standardize(f, g, h, isNegEdge);
@@ -145,7 +162,9 @@ BddMgrV::ite(BddNodeV f, BddNodeV g, BddNodeV h) {
     // BddCacheKey k;  // Change this line!!
     BddCacheKeyV k(f(), g(), h());
     size_t ret_t;
+    ++_numCacheLookups;
     if (_computedTable.read(k, ret_t)) {
+        ++_numCacheHits;
         if (isNegEdge) ret_t = ret_t ^ BDD_NEG_EDGEV;
         return ret_t;
     }
@@ -200,6 +219,82 @@ BddMgrV::ite(BddNodeV f, BddNodeV g, BddNodeV h) {
     return ret_t;
 }
 
+// f & g
+BddNodeV
+BddMgrV::bddAnd(BddNodeV f, BddNodeV g) {
+    ++_numBinCalls;
+    // terminal cases
+    if (f == BddNodeV::_zero || g == BddNodeV::_zero || f == ~g)
+        return BddNodeV::_zero;
+    if (f == BddNodeV::_one || f == g) return g;
+    if (g == BddNodeV::_one) return f;
+
+    // commutativity: f < g as raw edges
+    if (f() > g()) swapBddNodeV(f, g);
+
+    BddBinCacheKeyV k(f(), g(), BDD_BIN_AND);
+    size_t ret_t;
+    ++_numCacheLookups;
+    if (_binCache.read(k, ret_t)) {
+        ++_numCacheHits;
+        return ret_t;
+    }
+
+    unsigned v = f.getLevel();
+    if (g.getLevel() > v) v = g.getLevel();
+    BddNodeV t   = bddAnd(f.getLeftCofactor(v), g.getLeftCofactor(v));
+    BddNodeV e   = bddAnd(f.getRightCofactor(v), g.getRightCofactor(v));
+    BddNodeV ret = makeBddNodeV(v, t, e);
+
+    _binCache.write(k, ret());
+    return ret;
+}
+
+// f ^ g
+BddNodeV
+BddMgrV::bddXor(BddNodeV f, BddNodeV g) {
+    ++_numBinCalls;
+    // terminal cases
+    if (f == g) return BddNodeV::_zero;
+    if (f == ~g) return BddNodeV::_one;
+    if (f == BddNodeV::_zero) return g;
+    if (g == BddNodeV::_zero) return f;
+    if (f == BddNodeV::_one) return ~g;
+    if (g == BddNodeV::_one) return ~f;
+
+    // (~f) ^ g = f ^ (~g) = ~(f ^ g) ==> both operands are posEdge
+    bool isNegEdge = false;
+    if (f.isNegEdge()) {
+        f         = ~f;
+        isNegEdge = !isNegEdge;
+    }
+    if (g.isNegEdge()) {
+        g         = ~g;
+        isNegEdge = !isNegEdge;
+    }
+    // commutativity: f < g as raw edges
+    if (f() > g()) swapBddNodeV(f, g);
+
+    BddBinCacheKeyV k(f(), g(), BDD_BIN_XOR);
+    size_t ret_t;
+    ++_numCacheLookups;
+    if (_binCache.read(k, ret_t)) {
+        ++_numCacheHits;
+        if (isNegEdge) ret_t = ret_t ^ BDD_NEG_EDGEV;
+        return ret_t;
+    }
+
+    unsigned v = f.getLevel();
+    if (g.getLevel() > v) v = g.getLevel();
+    BddNodeV t   = bddXor(f.getLeftCofactor(v), g.getLeftCofactor(v));
+    BddNodeV e   = bddXor(f.getRightCofactor(v), g.getRightCofactor(v));
+    BddNodeV ret = makeBddNodeV(v, t, e);
+
+    _binCache.write(k, ret());
+    if (isNegEdge) ret = ~ret;
+    return ret;
+}
+
 void BddMgrV::standardize(BddNodeV& f, BddNodeV& g, BddNodeV& h, bool& isNegEdge) {
     // (1) Identical/Complement rules
     if (f == g)
@@ -259,6 +354,7 @@ BddMgrV::uniquify(size_t l, size_t r, unsigned i) {
     if (!_uniqueTable.check(k, n)) {
         n = new BddNodeVInt(l, r, i);
         _uniqueTable.forceInsert(k, n);
+        if (++_numNodes > _peakNodes) _peakNodes = _numNodes;
     }
     return n;
 }
@@ -373,6 +469,127 @@ bool BddMgrV::checkIteTerminal(const BddNodeV& f, const BddNodeV& g, const BddNo
     return false;
 }
 
+//----------------------------------------------------------------------
+//    Statistics functions
+//----------------------------------------------------------------------
+void BddMgrV::resetStats() {
+    _numIteCalls     = 0;
+    _numBinCalls     = 0;
+    _numCacheLookups = 0;
+    _numCacheHits    = 0;
+    _peakNodes       = _numNodes;
+}
+
+// live[l] / dead[l] ==> #nodes at level l with _refCount > 0 / == 0
+// [Note] Nodes are never freed until reset(), so dead nodes still occupy
+//        the unique table.
+void BddMgrV::countNodes(vector<size_t>& live, vector<size_t>& dead) const {
+    live.assign(_supports.size(), 0);
+    dead.assign(_supports.size(), 0);
+    BddHash::iterator bi = _uniqueTable.begin();
+    for (; bi != _uniqueTable.end(); ++bi) {
+        const BddNodeVInt* n = (*bi).second;
+        unsigned l           = n->getLevel();
+        if (l >= live.size()) {
+            live.resize(l + 1, 0);
+            dead.resize(l + 1, 0);
+        }
+        if (n->getRefCount() > 0) ++live[l];
+        else ++dead[l];
+    }
+}
+
+void BddMgrV::printStats(bool doLevel, bool doChain) const {
+    vector<size_t> live, dead;
+    countNodes(live, dead);
+    size_t nLive = 0, nDead = 0;
+    for (size_t l = 0, n = live.size(); l < n; ++l) {
+        nLive += live[l];
+        nDead += dead[l];
+    }
+    double hitRate = _numCacheLookups ? 100.0 * _numCacheHits / _numCacheLookups : 0.0;
+
+    cout << endl;
+    cout << "BDD Statistics" << endl
+         << "==============" << endl;
+    cout << "  " << setw(16) << left << "Nodes"
+         << setw(12) << right << _numNodes << endl;
+    cout << "  " << setw(16) << left << "  Live"
+         << setw(12) << right << nLive << endl;
+    cout << "  " << setw(16) << left << "  Dead"
+         << setw(12) << right << nDead << endl;
+    cout << "  " << setw(16) << left << "Peak nodes"
+         << setw(12) << right << _peakNodes << endl;
+    cout << "  " << setw(16) << left << "ITE calls"
+         << setw(12) << right << _numIteCalls << endl;
+    cout << "  " << setw(16) << left << "AND/XOR calls"
+         << setw(12) << right << _numBinCalls << endl;
+    cout << "  " << setw(16) << left << "Cache lookups"
+         << setw(12) << right << _numCacheLookups << endl;
+    cout << "  " << setw(16) << left << "Cache hits"
+         << setw(12) << right << _numCacheHits << " ("
+         << fixed << setprecision(2) << hitRate << "%)" << endl;
+    cout.unsetf(ios::floatfield);
+
+    if (doLevel) {
+        cout << endl
+             << "  " << setw(8) << left << "Level"
+             << setw(12) << right << "Live"
+             << setw(12) << right << "Dead" << endl;
+        cout << "  --------------------------------" << endl;
+        for (size_t l = live.size(); l-- > 0;) {
+            if (!live[l] && !dead[l]) continue;
+            cout << "  " << setw(8) << left << l
+                 << setw(12) << right << live[l]
+                 << setw(12) << right << dead[l] << endl;
+        }
+    }
+
+    if (doChain) {
+        // chainHist[i] ==> #buckets with chain length i; the last one is >=
+        const size_t maxLen = 8;
+        vector<size_t> chainHist(maxLen + 1, 0);
+        size_t longest = 0, nUsed = 0;
+        for (size_t b = 0, n = _uniqueTable.numBuckets(); b < n; ++b) {
+            size_t len = _uniqueTable[b].size();
+            if (len > longest) longest = len;
+            if (len) ++nUsed;
+            ++chainHist[(len < maxLen) ? len : maxLen];
+        }
+        cout << endl
+             << "  Unique table: " << _uniqueTable.numBuckets() << " buckets, "
+             << nUsed << " used, longest chain = " << longest << endl;
+        for (size_t i = 0; i <= maxLen; ++i) {
+            cout << "  " << ((i == maxLen) ? ">=" : "  ") << setw(6) << left << i
+                 << setw(12) << right << chainHist[i] << endl;
+        }
+    }
+}
+
+// One row per call; columns are fixed by writeStatsHeader()
+void BddMgrV::writeStatsHeader(ostream& os) const {
+    os << "iter,nodes,live,dead,peak,ite,andxor,lookups,hits";
+    for (size_t l = 1, n = _supports.size(); l < n; ++l)
+        os << ",live_L" << l;
+    os << endl;
+}
+
+void BddMgrV::writeStatsRow(ostream& os, size_t iter) const {
+    vector<size_t> live, dead;
+    countNodes(live, dead);
+    size_t nLive = 0, nDead = 0;
+    for (size_t l = 0, n = live.size(); l < n; ++l) {
+        nLive += live[l];
+        nDead += dead[l];
+    }
+    os << iter << "," << _numNodes << "," << nLive << "," << nDead << ","
+       << _peakNodes << "," << _numIteCalls << "," << _numBinCalls << ","
+       << _numCacheLookups << "," << _numCacheHits;
+    for (size_t l = 1, n = _supports.size(); l < n; ++l)
+        os << "," << live[l];
+    os << endl;
+}
+
 //----------------------------------------------------------------------
 //    Application functions
 //----------------------------------------------------------------------
@@ -403,6 +620,155 @@ int BddMgrV::evalCube(const BddNodeV& node, const string& pattern) const {
     return (next == BddNodeV::_one) ? 1 : 0;
 }
 
+// Collect the nodes in the cone of n (pointer part only) in topological
+// order, i.e. children before parents
+void BddMgrV::collectBddNodes(size_t n, map<size_t, size_t>& nodeIdx,
+                              vector<size_t>& order) const {
+    n = n & BDD_NODE_PTR_MASKV;
+    if (nodeIdx.find(n) != nodeIdx.end()) return;
+    const BddNodeV& left  = ((BddNodeVInt*)n)->getLeft();
+    const BddNodeV& right = ((BddNodeVInt*)n)->getRight();
+    if (left() != 0) collectBddNodes(left(), nodeIdx, order);
+    if (right() != 0) collectBddNodes(right(), nodeIdx, order);
+    nodeIdx[n] = order.size();
+    order.push_back(n);
+}
+
+// Bit-parallel evaluation of (64 * nWords) patterns.
+// inputs[(l - 1) * nWords + w] ==> word w of the values of support l
+// values[w]                    ==> word w of the values of node
+//
+void BddMgrV::evalPatterns(const BddNodeV& node, const vector<size_t>& inputs,
+                           size_t nWords, vector<size_t>& values) const {
+    assert(inputs.size() >= node.getLevel() * nWords);
+    BddEvalNet net;
+    buildEvalNet(node, net);
+    evalPatterns(net, inputs, nWords, values);
+}
+
+// Collect the cone of node in topological order, with the children of
+// each node as indices into the order
+void BddMgrV::buildEvalNet(const BddNodeV& node, BddEvalNet& net) const {
+    map<size_t, size_t> nodeIdx;
+    vector<size_t> order;
+    collectBddNodes(node(), nodeIdx, order);
+
+    size_t nNodes = order.size();
+    net.levels.resize(nNodes);
+    net.leftIdx.assign(nNodes, 0);
+    net.rightIdx.assign(nNodes, 0);
+    net.leftMask.assign(nNodes, 0);
+    net.rightMask.assign(nNodes, 0);
+    for (size_t i = 0; i < nNodes; ++i) {
+        const BddNodeVInt* n = (BddNodeVInt*)order[i];
+        net.levels[i]        = n->getLevel();
+        if (n->getLevel() == 0) continue;
+        size_t l = n->getLeft()(), r = n->getRight()();
+        net.leftIdx[i]   = nodeIdx[l & BDD_NODE_PTR_MASKV];
+        net.rightIdx[i]  = nodeIdx[r & BDD_NODE_PTR_MASKV];
+        net.leftMask[i]  = (l & BDD_NEG_EDGEV) ? ~size_t(0) : 0;
+        net.rightMask[i] = (r & BDD_NEG_EDGEV) ? ~size_t(0) : 0;
+    }
+    net.rootMask = node.isNegEdge() ? ~size_t(0) : 0;
+    net.nodeVal.resize(nNodes * BDD_SIM_WORDS);
+}
+
+// Each node of net is visited once per BDD_SIM_WORDS words, so the cost is
+// O(#nodes * nWords) instead of O(#levels * #patterns).
+//
+void BddMgrV::evalPatterns(BddEvalNet& net, const vector<size_t>& inputs,
+                           size_t nWords, vector<size_t>& values) const {
+    const size_t nNodes = net.levels.size();
+    vector<size_t>& nodeVal = net.nodeVal;
+    values.assign(nWords, 0);
+    for (size_t b = 0; b < nWords; b += BDD_SIM_WORDS) {
+        size_t nw = nWords - b;
+        if (nw > BDD_SIM_WORDS) nw = BDD_SIM_WORDS;
+        for (size_t i = 0; i < nNodes; ++i) {
+            size_t* val    = &nodeVal[i * BDD_SIM_WORDS];
+            unsigned level = net.levels[i];
+            if (level == 0) {  // const 1
+                for (size_t w = 0; w < BDD_SIM_WORDS; ++w) val[w] = ~size_t(0);
+                continue;
+            }
+            const size_t* x  = &inputs[(level - 1) * nWords + b];
+            const size_t* lv = &nodeVal[net.leftIdx[i] * BDD_SIM_WORDS];
+            const size_t* rv = &nodeVal[net.rightIdx[i] * BDD_SIM_WORDS];
+            size_t lm = net.leftMask[i], rm = net.rightMask[i];
+            for (size_t w = 0; w < nw; ++w)
+                val[w] = (x[w] & (lv[w] ^ lm)) | (~x[w] & (rv[w] ^ rm));
+        }
+        const size_t* rootVal = &nodeVal[(nNodes - 1) * BDD_SIM_WORDS];
+        for (size_t w = 0; w < nw; ++w) values[b + w] = rootVal[w] ^ net.rootMask;
+    }
+}
+
+// Evaluate node on the patterns in patternFile, one 0/1 string per pattern
+// (same format as in CIRSIMulate -File); character i is the value of
+// support (i + 1).
+// If simLog is given, "<pattern> <value>" is written for each pattern.
+// Return false if the file contains an illegal pattern.
+//
+bool BddMgrV::evalPatternFile(const BddNodeV& node, ifstream& patternFile,
+                              ostream* simLog) const {
+    const size_t nBatch = 64 * BDD_SIM_WORDS;
+    size_t nin = 0, nPatterns = 0, nOnes = 0;
+    vector<string> patterns;
+    vector<size_t> inputs, values;
+    string str;
+    bool isEnd = false;
+    BddEvalNet net;  // the cone is walked once for all the batches
+    buildEvalNet(node, net);
+    while (!isEnd) {
+        patterns.clear();
+        while (patterns.size() < nBatch) {
+            if (!(patternFile >> str)) {
+                isEnd = true;
+                break;
+            }
+            if (nin == 0) {
+                nin = str.size();
+                if (nin < node.getLevel()) {
+                    cerr << "Error: " << str << " too short!!" << endl;
+                    return false;
+                }
+            } else if (str.size() != nin) {
+                cerr << "Error: Pattern(" << str << ") length(" << str.size()
+                     << ") does not match the previous ones(" << nin << ")!!"
+                     << endl;
+                return false;
+            }
+            patterns.push_back(str);
+        }
+        if (patterns.empty()) break;
+
+        size_t nWords = (patterns.size() + 63) / 64;
+        inputs.assign(nin * nWords, 0);
+        for (size_t p = 0, np = patterns.size(); p < np; ++p)
+            for (size_t i = 0; i < nin; ++i) {
+                char c = patterns[p][i];
+                if (c == '1')
+                    inputs[i * nWords + p / 64] |= (size_t(1) << (p % 64));
+                else if (c != '0') {
+                    cerr << "Illegal pattern: " << c << "(" << i << ")"
+                         << endl;
+                    return false;
+                }
+            }
+        evalPatterns(net, inputs, nWords, values);
+
+        for (size_t p = 0, np = patterns.size(); p < np; ++p) {
+            bool v = (values[p / 64] >> (p % 64)) & 1;
+            if (v) ++nOnes;
+            if (simLog) (*simLog) << patterns[p] << " " << v << endl;
+        }
+        nPatterns += patterns.size();
+    }
+    cout << "BDD Simulate: " << nPatterns << " patterns simulated, " << nOnes
+         << " evaluated to 1." << endl;
+    return true;
+}
+
 bool BddMgrV::drawBdd(const string& name, const string& fileName) const {
     BddNodeV node = ::getBddNodeV(name);
     if (node() == 0) {
@@ -439,30 +805,116 @@ bool BddMgrV::drawFdd(const string& name, const string& fileName) const {
     return true;
 }
 
-/// implementation of restrict
+// Return the node (v ? t : e); the complement bubble is kept on the
+// else edge as in ite()
+BddNodeV
+BddMgrV::makeBddNodeV(unsigned v, BddNodeV t, BddNodeV e) {
+    if (t == e) return t;
+    bool isNegEdge = t.isNegEdge();
+    if (isNegEdge) {
+        t = ~t;
+        e = ~e;
+    }
+    BddNodeV ret(uniquify(t(), e(), v));
+    if (isNegEdge) ret = ~ret;
+    return ret;
+}
 
+// Generalized cofactor f|c (Coudert & Madre):
+//    agrees with f wherever c = 1;
+//    for c = 0, maps each minterm to the closest one in c
+// [Note] c = 0 is meaningless; return 0 in this case
+//
 BddNodeV
-BddMgrV::restrict(const BddNodeV& f,const BddNodeV& c)
-{
-    if(c == BddNodeV::_zero){
-        cerr << "Error: " << endl;
-        return BddNodeV::_zero;
+BddMgrV::constrain(BddNodeV f, BddNodeV c) {
+    // terminal cases
+    if (c == BddNodeV::_zero) return BddNodeV::_zero;
+    if (c == BddNodeV::_one || f.getLevel() == 0) return f;
+    if (f == c) return BddNodeV::_one;
+    if (f == ~c) return BddNodeV::_zero;
+
+    // constrain(~f, c) = ~constrain(f, c)
+    bool isNegEdge = f.isNegEdge();
+    if (isNegEdge) f = ~f;
+
+    BddCacheKeyV k(f(), c(), BDD_CACHE_CONSTRAIN);
+    size_t ret_t;
+    ++_numCacheLookups;
+    if (_computedTable.read(k, ret_t)) {
+        ++_numCacheHits;
+        if (isNegEdge) ret_t = ret_t ^ BDD_NEG_EDGEV;
+        return ret_t;
     }
-    if(c == BddNodeV::_one || f == BddNodeV::_zero || f == BddNodeV::_one)
-        return f;
-    //a = c.root
-    int a = c.getLevel();
-    if(c.getRightCofactor(a) == BddNodeV::_zero)
-        return restrict(f.getLeftCofactor(a), c.getLeftCofactor(a));
-    if(c.getLeftCofactor(a) == BddNodeV::_zero)
-        return restrict(f.getRightCofactor(a), c.getRightCofactor(a));
-    if(f.getLeftCofactor(a) == f.getRightCofactor(a))
-        return restrict(f, c.getLeftCofactor(a) | c.getRightCofactor(a));
 
-    return ((~getSupport(a)) & restrict(f.getRightCofactor(a), c.getRightCofactor(a))) |
-    ((getSupport(a)) & restrict(f.getLeftCofactor(a), c.getLeftCofactor(a)));
+    unsigned v = f.getLevel();
+    if (c.getLevel() > v) v = c.getLevel();
+
+    BddNodeV cl = c.getLeftCofactor(v), cr = c.getRightCofactor(v);
+    BddNodeV ret;
+    if (cr == BddNodeV::_zero)
+        ret = constrain(f.getLeftCofactor(v), cl);
+    else if (cl == BddNodeV::_zero)
+        ret = constrain(f.getRightCofactor(v), cr);
+    else {
+        BddNodeV t = constrain(f.getLeftCofactor(v), cl);
+        BddNodeV e = constrain(f.getRightCofactor(v), cr);
+        ret        = makeBddNodeV(v, t, e);
+    }
+
+    _computedTable.write(k, ret());
+    if (isNegEdge) ret = ~ret;
+    return ret;
 }
 
+// Restrict f to the care set c (Coudert & Madre):
+//    agrees with f wherever c = 1; unlike constrain(), variables that
+//    are not in the support of f are quantified out of c, so the result
+//    never depends on variables outside supp(f)
+// [Note] c = 0 means everything is don't care; return f in this case
+//
+BddNodeV
+BddMgrV::restrict(BddNodeV f, BddNodeV c) {
+    // terminal cases
+    if (c == BddNodeV::_zero || c == BddNodeV::_one || f.getLevel() == 0)
+        return f;
+    if (f == c) return BddNodeV::_one;
+    if (f == ~c) return BddNodeV::_zero;
+
+    // restrict(~f, c) = ~restrict(f, c)
+    bool isNegEdge = f.isNegEdge();
+    if (isNegEdge) f = ~f;
+
+    BddCacheKeyV k(f(), c(), BDD_CACHE_RESTRICT);
+    size_t ret_t;
+    ++_numCacheLookups;
+    if (_computedTable.read(k, ret_t)) {
+        ++_numCacheHits;
+        if (isNegEdge) ret_t = ret_t ^ BDD_NEG_EDGEV;
+        return ret_t;
+    }
+
+    BddNodeV ret;
+    unsigned v = f.getLevel(), vc = c.getLevel();
+    if (vc > v)
+        // top variable of c is not in f ==> c := exist(c, vc)
+        ret = restrict(f, c.getLeftCofactor(vc) | c.getRightCofactor(vc));
+    else {
+        BddNodeV cl = c.getLeftCofactor(v), cr = c.getRightCofactor(v);
+        if (cr == BddNodeV::_zero)
+            ret = restrict(f.getLeftCofactor(v), cl);
+        else if (cl == BddNodeV::_zero)
+            ret = restrict(f.getRightCofactor(v), cr);
+        else {
+            BddNodeV t = restrict(f.getLeftCofactor(v), cl);
+            BddNodeV e = restrict(f.getRightCofactor(v), cr);
+            ret        = makeBddNodeV(v, t, e);
+        }
+    }
+
+    _computedTable.write(k, ret());
+    if (isNegEdge) ret = ~ret;
+    return ret;
+}
 
 //implementation for FDD operations
 
@@ -9,6 +9,7 @@
 #ifndef BDD_MGRV_H
 #define BDD_MGRV_H
 
+#include <fstream>
 #include <map>
 
 #include "bddNodeV.h"
@@ -21,12 +22,27 @@ using namespace std;
 
 class BddNodeV;
 
+// #words (of 64 patterns each) evaluated together in evalPatterns()
+#define BDD_SIM_WORDS 4
+
+// The cone of a BDD node in topological order (the children first, the
+// node last), built once by BddMgrV::buildEvalNet() and reused by
+// evalPatterns() for every batch of patterns
+struct BddEvalNet {
+    vector<unsigned> levels;  // level of each node; 0 for const 1
+    vector<size_t> leftIdx, rightIdx;    // index of the children
+    vector<size_t> leftMask, rightMask;  // ~0 if the edge is complemented
+    size_t rootMask;
+    vector<size_t> nodeVal;  // scratch: BDD_SIM_WORDS words per node
+};
+
 typedef vector<size_t> BddArr;
 typedef map<string, size_t> BddMap;
 typedef pair<string, size_t> BddMapPair;
 typedef map<string, size_t>::const_iterator BddMapConstIter;
 
-extern BddMgrV* bddMgrV;
+// current manager of the calling thread (see BddMgrV::activate())
+extern thread_local BddMgrV* bddMgrV;
 
 class BddHashKeyV {
 public:
@@ -71,20 +87,69 @@ private:
     size_t _h;
 };
 
+// Cache key for the binary operations (bddAnd/bddXor).
+// The operation tag is kept in bit 1 of _g, which is free in a BddNodeV
+// (see BDD_EDGEV_BITS). Both kernels order the operands (f < g). bddXor()
+// also strips the complement bits of f and g and applies them to the
+// result, so its keys are two regular edges. bddAnd() keys keep the
+// complemented edges as they are.
+class BddBinCacheKeyV {
+public:
+    BddBinCacheKeyV() {}
+    BddBinCacheKeyV(size_t f, size_t g, size_t op) : _f(f), _g(g | op) {}
+
+    size_t operator()() const { return ((_f << 3) ^ (_g << 6)); }
+
+    bool operator==(const BddBinCacheKeyV& k) const {
+        return (_f == k._f) && (_g == k._g);
+    }
+
+private:
+    size_t _f;
+    size_t _g;
+};
+
+enum BDD_BIN_OPV {
+    BDD_BIN_AND = 0,
+    BDD_BIN_XOR = 2,
+};
+
+// Operation tags for non-ITE entries in _computedTable.
+// They are kept in the 3rd field of BddCacheKeyV, which for ITE always holds
+// a (non-null) BddNodeV, so the two kinds of entries never collide.
+enum BDD_CACHE_OPV {
+    BDD_CACHE_CONSTRAIN = 2,
+    BDD_CACHE_RESTRICT  = 4,
+};
+
 class BddMgrV {
     typedef HashMap<BddHashKeyV, BddNodeVInt*> BddHash;
     typedef HashMap<BddHashKeyV, FddNodeVInt*> FddHash;
     typedef Cache<BddCacheKeyV, size_t> BddCache;
+    typedef Cache<BddBinCacheKeyV, size_t> BddBinCache;
 
 public:
-    BddMgrV(size_t nin = 128, size_t h = 8009, size_t c = 30011) { init(nin, h, c); }
-    ~BddMgrV() { reset(); }
+    BddMgrV(size_t nin = 128, size_t h = 8009, size_t c = 30011) : _statsLog(0) {
+        init(nin, h, c);
+    }
+    ~BddMgrV();
 
     void init(size_t nin, size_t h, size_t c);
     void restart();
+    // Make this the current manager of the calling thread, i.e. the one
+    // used through bddMgrV and by BddNodeV/FddNodeV operations.
+    // [Note] A BddNodeV can only be operated on while its manager is the
+    //        current one.
+    void activate();
 
     // for building BDDs
     BddNodeV ite(BddNodeV f, BddNodeV g, BddNodeV h);
+    // dedicated kernels for AND/XOR (OR is ~AND(~f, ~g))
+    BddNodeV bddAnd(BddNodeV f, BddNodeV g);
+    BddNodeV bddXor(BddNodeV f, BddNodeV g);
+    // Coudert-Madre generalized cofactors; f is don't care where c is 0
+    BddNodeV constrain(BddNodeV f, BddNodeV c);
+    BddNodeV restrict(BddNodeV f, BddNodeV c);
 
     // for _supports
     const BddNodeV& getSupport(size_t i) const { return _supports[i]; }
@@ -113,8 +178,22 @@ public:
     void forceAddFddNodeV(const string& nodeName, size_t nodeV);
     FddNodeV getFddNodeV(const string& nodeName) const;
 
+    // For BDD statistics (BSTATs)
+    void resetStats();
+    void printStats(bool doLevel, bool doChain) const;
+    void writeStatsHeader(ostream& os) const;
+    void writeStatsRow(ostream& os, size_t iter) const;
+    void setStatsLog(ofstream* logFile) { _statsLog = logFile; }
+
     // Applications
     int evalCube(const BddNodeV& node, const string& vector) const;
+    void evalPatterns(const BddNodeV& node, const vector<size_t>& inputs,
+                      size_t nWords, vector<size_t>& values) const;
+    void buildEvalNet(const BddNodeV& node, BddEvalNet& net) const;
+    void evalPatterns(BddEvalNet& net, const vector<size_t>& inputs,
+                      size_t nWords, vector<size_t>& values) const;
+    bool evalPatternFile(const BddNodeV& node, ifstream& patternFile,
+                         ostream* simLog) const;
     bool drawBdd(const string& nodeName, const string& dotFile) const;
 
     // operation for fdd
@@ -133,7 +212,6 @@ public:
     void buildPInitialState();
     void buildPTransRelation();
     void buildPImage(int level);
-    BddNodeV restrict(const BddNodeV&, const BddNodeV&);
     void runPCheckProperty(const string& name, BddNodeV property);
     bool isPFixed() const { return _isFixed; }
     BddNodeV getPInitState() const { return _initState; }
@@ -160,6 +238,7 @@ private:
     vector<BddNodeV> _supports;
     BddHash _uniqueTable;
     BddCache _computedTable;
+    BddBinCache _binCache;
 
     // implement for fdd
     vector<FddNodeV>  _fddsupports;
@@ -178,10 +257,23 @@ private:
     BddNodeV _tri;
     vector<BddNodeV> _reachStates;
 
+    // For statistics
+    size_t _numNodes;
+    size_t _numIteCalls;
+    size_t _numBinCalls;
+    size_t _numCacheLookups;
+    size_t _numCacheHits;
+    size_t _peakNodes;
+    ofstream* _statsLog;
+
     void reset();
+    void countNodes(vector<size_t>& live, vector<size_t>& dead) const;
     bool checkIteTerminal(const BddNodeV&, const BddNodeV&, const BddNodeV&,
                           BddNodeV&);
     void standardize(BddNodeV& f, BddNodeV& g, BddNodeV& h, bool& isNegEdge);
+    BddNodeV makeBddNodeV(unsigned v, BddNodeV t, BddNodeV e);
+    void collectBddNodes(size_t n, map<size_t, size_t>& nodeIdx,
+                         vector<size_t>& order) const;
 };
 
 #endif  // BDD_MGRV_H
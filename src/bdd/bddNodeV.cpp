@@ -17,10 +17,12 @@
 
 // Initialize static data members
 //
-BddMgrV* BddNodeV::_BddMgrV         = 0;
-BddNodeVInt* BddNodeVInt::_terminal = 0;
-BddNodeV BddNodeV::_one;
-BddNodeV BddNodeV::_zero;
+thread_local BddMgrV* BddNodeV::_BddMgrV = 0;
+// The terminal node is shared by all BddMgrV's and never deleted,
+// so _one and _zero are valid in every manager
+BddNodeVInt* BddNodeVInt::_terminal = new BddNodeVInt;
+BddNodeV BddNodeV::_one(BddNodeVInt::_terminal, BDD_POS_EDGEV);
+BddNodeV BddNodeV::_zero(BddNodeVInt::_terminal, BDD_NEG_EDGEV);
 bool BddNodeV::_debugBddAddr  = false;
 bool BddNodeV::_debugRefCount = false;
 
@@ -148,7 +150,7 @@ BddNodeV::operator=(const BddNodeV& n) {
 
 BddNodeV
 BddNodeV::operator&(const BddNodeV& n) const {
-    return _BddMgrV->ite((*this), n, BddNodeV::_zero);
+    return _BddMgrV->bddAnd((*this), n);
 }
 
 BddNodeV&
@@ -159,7 +161,7 @@ BddNodeV::operator&=(const BddNodeV& n) {
 
 BddNodeV
 BddNodeV::operator|(const BddNodeV& n) const {
-    return _BddMgrV->ite((*this), BddNodeV::_one, n);
+    return ~(_BddMgrV->bddAnd(~(*this), ~n));
 }
 
 BddNodeV&
@@ -170,7 +172,7 @@ BddNodeV::operator|=(const BddNodeV& n) {
 
 BddNodeV
 BddNodeV::operator^(const BddNodeV& n) const {
-    return _BddMgrV->ite((*this), ~n, n);
+    return _BddMgrV->bddXor((*this), n);
 }
 
 BddNodeV&
@@ -95,12 +95,14 @@ public:
 
     // Static functions
     static void setBddMgrV(BddMgrV* m) { _BddMgrV = m; }
+    static BddMgrV* getBddMgrV() { return _BddMgrV; }
 
 private:
     size_t _nodeV;
 
     // Static data mebers
-    static BddMgrV* _BddMgrV;
+    // current manager of the calling thread (see BddMgrV::activate())
+    static thread_local BddMgrV* _BddMgrV;
 
     // Private functions
     BddNodeVInt* getBddNodeVInt() const {
@@ -137,8 +139,9 @@ class BddNodeVInt {
     const BddNodeV& getRight() const { return _right; }
     unsigned getLevel() const { return _level; }
     unsigned getRefCount() const { return _refCount; }
-    void incRefCount() { ++_refCount; }
-    void decRefCount() { --_refCount; }
+    // _terminal is shared by all BddMgrV's ==> not ref-counted
+    void incRefCount() { if (_level) ++_refCount; }
+    void decRefCount() { if (_level) --_refCount; }
     bool isVisited() const { return (_visited == 1); }
     void setVisited() { _visited = 1; }
     void unsetVisited() { _visited = 0; }
@@ -15,10 +15,11 @@
 
 // Initialize static data members
 //
-BddMgrV* FddNodeV::_BddMgrV = 0;
-FddNodeVInt* FddNodeVInt::_terminal = 0;
-FddNodeV FddNodeV::_one;
-FddNodeV FddNodeV::_zero;
+thread_local BddMgrV* FddNodeV::_BddMgrV = 0;
+// The terminal node is shared by all BddMgrV's and never deleted
+FddNodeVInt* FddNodeVInt::_terminal = new FddNodeVInt;
+FddNodeV FddNodeV::_one(FddNodeVInt::_terminal, FDD_POS_EDGE);
+FddNodeV FddNodeV::_zero(FddNodeVInt::_terminal, FDD_NEG_EDGE);
 bool FddNodeV::_debugBddAddr = false;
 bool FddNodeV::_debugRefCount = false;
 
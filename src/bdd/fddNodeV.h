@@ -100,6 +100,7 @@ public:
 
    // Static functions
    static void setBddMgrV(BddMgrV* m) { _BddMgrV = m; }
+   static BddMgrV* getBddMgrV() { return _BddMgrV; }
 
    //test
    void print(){cout<<_node<<endl;}
@@ -108,7 +109,8 @@ private:
    size_t                  _node;
 
    // Static data mebers
-   static BddMgrV*          _BddMgrV;
+   // current manager of the calling thread (see BddMgrV::activate())
+   static thread_local BddMgrV* _BddMgrV;
 
    // Private functions
    FddNodeVInt* getFddNodeVInt() const {
@@ -146,8 +148,9 @@ class FddNodeVInt
    const FddNodeV& getRight() const { return _right; }
    unsigned getLevel() const { return _level; }
    unsigned getRefCount() const { return _refCount; }
-   void incRefCount() { ++_refCount; }
-   void decRefCount() { --_refCount; }
+   // _terminal is shared by all BddMgrV's ==> not ref-counted
+   void incRefCount() { if (_level) ++_refCount; }
+   void decRefCount() { if (_level) --_refCount; }
    bool isVisited() const { return (_visited == 1); }
    void setVisited() { _visited = 1; }
    void unsetVisited() { _visited = 0; }
@@ -16,6 +16,7 @@
 #include "cirDef.h"
 #include "cirGate.h"
 #include "cirMgr.h"
+#include "util.h"
 #include "yosysMgr.h"
 
 /**
@@ -99,69 +100,98 @@ void CirMgr::reorderGateId(IDMap& aigIdMap) {
     }
 }
 
+/**
+ * @brief Builds the structural hash table from the existing AND gates.
+ */
+void CirMgr::initStrash() {
+    _strashHash.init(getHashSize(getNumTots() * 2));
+    for (size_t i = 0, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g == 0 || !g->isAig()) continue;
+        _strashHash.insert(CirStrashKey(g->getIn0()(), g->getIn1()()), g);
+    }
+}
+
+/**
+ * @brief Returns the constant value of a literal.
+ *
+ * @param v The literal.
+ * @return  0 or 1 if v is a constant; otherwise, -1.
+ */
+int CirMgr::getConstValue(const CirGateV& v) const {
+    if (v.gate() == _const0) return v.isInv() ? 1 : 0;
+    if (_const1 != 0 && v.gate() == _const1) return v.isInv() ? 0 : 1;
+    return -1;
+}
+
 /**
  * @brief Creates a NOT gate in the circuit.
  *
- * @param in0 The input gate for the NOT gate.
- * @return    Returns a pointer to the created NOT gate.
+ * @param in0 The input literal of the NOT gate.
+ * @return    Returns the complemented literal; no gate is created.
  */
-CirGate* CirMgr::createNotGate(CirGate* in0) {
-    CirGate* notGate = new CirAigGate(getNumTots(), 0);
-    addTotGate(notGate);
-    notGate->setIn0(in0, true);
-    notGate->setIn1(_const1, false);
-    return notGate;
+CirGateV CirMgr::createNotGate(const CirGateV& in0) {
+    return ~in0;
 }
 
 /**
  * @brief  Creates an AND gate in the circuit.
  *
- * @param in0 The first input gate for the AND gate.
- * @param in1 The second input gate for the AND gate.
- * @return    Returns a pointer to the created AND gate.
+ * Trivial cases (x & 0, x & 1, x & x, x & ~x) are simplified, and an
+ * existing gate with the same fanins is returned if there is one. The
+ * returned gate is kept in the DFS list and the fanout lists.
+ *
+ * @param in0 The first input literal of the AND gate.
+ * @param in1 The second input literal of the AND gate.
+ * @return    Returns the literal of the AND gate.
  */
-CirGate* CirMgr::createAndGate(CirGate* in0, CirGate* in1) {
-    CirGate* andGate = new CirAigGate(getNumTots(), 0);
+CirGateV CirMgr::createAndGate(const CirGateV& in0, const CirGateV& in1) {
+    int c0 = getConstValue(in0), c1 = getConstValue(in1);
+    if (c0 == 0) return in0;
+    if (c1 == 0) return in1;
+    if (c0 == 1 || in0 == in1) return in1;
+    if (c1 == 1) return in0;
+    if (in0 == ~in1) return CirGateV(_const0, false);
+
+    if (_strashHash.numBuckets() == 0) initStrash();
+    CirStrashKey k(in0(), in1());
+    CirGate* andGate = 0;
+    if (_strashHash.check(k, andGate)) {
+        addDfsGate(andGate);  // may be a dangling gate
+        return CirGateV(andGate, false);
+    }
+
+    andGate = new CirAigGate(getNumTots());
     addTotGate(andGate);
-    andGate->setIn0(in0, false);
-    andGate->setIn1(in1, false);
-    return andGate;
+    andGate->setIn0(in0.gate(), in0.isInv());
+    andGate->setIn1(in1.gate(), in1.isInv());
+    _strashHash.forceInsert(k, andGate);
+    _aigList.push_back(static_cast<CirAigGate*>(andGate));
+    addDfsGate(andGate);
+    return CirGateV(andGate, false);
 }
 
 /**
  * @brief Creates an OR gate in the circuit.
  *
- * @param in0 The first input gate for the OR gate.
- * @param in1 The second input gate for the OR gate.
- * @return    Returns a pointer to the created OR gate.
+ * @param in0 The first input literal of the OR gate.
+ * @param in1 The second input literal of the OR gate.
+ * @return    Returns the literal of the OR gate, i.e. ~(~in0 & ~in1).
  */
-CirGate* CirMgr::createOrGate(CirGate* in0, CirGate* in1) {
-    CirGate* tmpGate = new CirAigGate(getNumTots(), 0);
-    addTotGate(tmpGate);
-    tmpGate->setIn0(in0, true);
-    tmpGate->setIn1(in1, true);
-    return createNotGate(tmpGate);
+CirGateV CirMgr::createOrGate(const CirGateV& in0, const CirGateV& in1) {
+    return ~createAndGate(~in0, ~in1);
 }
 
 /**
  * @brief Creates an XOR gate in the circuit.
  *
- * @param in0 The first input gate for the XOR gate.
- * @param in1 The second input gate for the XOR gate.
- * @return    Returns a pointer to the created XOR gate.
+ * @param in0 The first input literal of the XOR gate.
+ * @param in1 The second input literal of the XOR gate.
+ * @return    Returns the literal of the XOR gate,
+ *            i.e. ~(~(~in0 & in1) & ~(in0 & ~in1)).
  */
-CirGate* CirMgr::createXorGate(CirGate* in0, CirGate* in1) {
-    CirGate* tmpGate0 = new CirAigGate(getNumTots(), 0);
-    addTotGate(tmpGate0);
-    CirGate* tmpGate1 = new CirAigGate(getNumTots(), 0);
-    addTotGate(tmpGate1);
-    CirGate* tmpGate2 = new CirAigGate(getNumTots(), 0);
-    addTotGate(tmpGate2);
-    tmpGate0->setIn0(in0, true);
-    tmpGate0->setIn1(in1, false);
-    tmpGate1->setIn0(in0, false);
-    tmpGate1->setIn1(in1, true);
-    tmpGate2->setIn0(tmpGate0, true);
-    tmpGate2->setIn1(tmpGate1, true);
-    return createNotGate(tmpGate2);
+CirGateV CirMgr::createXorGate(const CirGateV& in0, const CirGateV& in1) {
+    CirGateV tmp0 = createAndGate(~in0, in1);
+    CirGateV tmp1 = createAndGate(in0, ~in1);
+    return createOrGate(tmp0, tmp1);
 }
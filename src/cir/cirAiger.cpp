@@ -0,0 +1,196 @@
+/****************************************************************************
+  FileName     [ cirAiger.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the native binary AIGER reader ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+#include "cirDef.h"
+#include "cirGate.h"
+#include "cirMgr.h"
+#include "util.h"
+
+using namespace std;
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// Cursor over the mapped file
+struct CirAigReader {
+    const unsigned char* _cur;
+    const unsigned char* _end;
+
+    bool eof() const { return _cur >= _end; }
+    bool skip(char c) {
+        if (eof() || *_cur != c) return false;
+        ++_cur;
+        return true;
+    }
+    // Unsigned ASCII number
+    bool getUint(unsigned& n) {
+        if (eof() || !isdigit(*_cur)) return false;
+        size_t v = 0;
+        while (!eof() && isdigit(*_cur)) {
+            v = v * 10 + (*_cur++ - '0');
+            if (v > UINT_MAX) return false;
+        }
+        n = v;
+        return true;
+    }
+    // 7-bit variable-length delta of the binary AND section
+    bool getDelta(unsigned& n) {
+        size_t v = 0;
+        for (unsigned shift = 0; !eof(); shift += 7) {
+            unsigned char c = *_cur++;
+            if (shift > 28) return false;
+            v |= size_t(c & 0x7f) << shift;
+            if (!(c & 0x80)) {
+                if (v > UINT_MAX) return false;
+                n = v;
+                return true;
+            }
+        }
+        return false;
+    }
+    // The rest of the line is the literal list of the line
+    bool getLits(unsigned* lits, unsigned max, unsigned& n) {
+        for (n = 0; n < max; ++n) {
+            if (n && !skip(' ')) break;
+            if (!getUint(lits[n])) return false;
+        }
+        return skip('\n');
+    }
+};
+
+/**********************************************/
+/*   Public member functions about AIGER I/O   */
+/**********************************************/
+/**
+ * @brief Reads a binary AIGER (1.9) file without going through ABC.
+ *
+ * The file is memory-mapped and the AND gates are decoded from the delta
+ * stream straight into _totGateList, which is sized from the header. The
+ * gate IDs are the same as those given by readCirFromAbc(): the AIGER
+ * variables first, then the POs, then the RIs, then const 1. Bad-state
+ * and invariant-constraint properties become extra POs. ASCII files,
+ * justice/fairness properties and non-zero latch resets are passed to
+ * readCirFromAbc().
+ *
+ * @param fileName The name of the .aig file.
+ * @return         Returns true if the circuit is successfully read; otherwise, false.
+ */
+bool CirMgr::readAig(const string& fileName) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Cannot open design \"" << fileName << "\"!!" << endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        cerr << "Error: \"" << fileName << "\" is empty!!" << endl;
+        return false;
+    }
+    const size_t size = st.st_size;
+    void* mem         = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        cerr << "Error: cannot map \"" << fileName << "\"!!" << endl;
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise(mem, size, MADV_SEQUENTIAL);
+#endif
+    CirAigReader in = {(const unsigned char*)mem, (const unsigned char*)mem + size};
+
+    int ret = readAigBody(in);
+    munmap(mem, size);
+    if (ret < 0) return readCirFromAbc(fileName, AIGER);
+    if (ret == 0) {
+        cerr << "Error: \"" << fileName << "\" is not a legal binary AIGER file!!"
+             << endl;
+        return false;
+    }
+    this->fileName = fileName;
+    genDfsList();
+    return true;
+}
+
+/***********************************************/
+/*   Private member functions about AIGER I/O   */
+/***********************************************/
+// return 1 if read, 0 if the file is illegal, or -1 if the file should be
+// read by ABC. -1 is only returned before initCir(), so the manager is
+// still empty for the ABC fallback. 0 may come after initCir() and the
+// PI/RO gates, e.g. from the AND section: the manager is then half built
+// and the caller must delete it.
+int CirMgr::readAigBody(CirAigReader& in) {
+    // aig M I L O A [B C J F]
+    unsigned hdr[9] = {0}, nHdr = 0;
+    if (in.skip('a') && in.skip('a')) {  // "aag"; "aig" stops at the 'i'
+        if (in.skip('g')) return -1;  // ASCII AIGER
+        return 0;
+    }
+    if (!in.skip('i') || !in.skip('g') || !in.skip(' ')) return 0;
+    if (!in.getLits(hdr, 9, nHdr) || nHdr < 5) return 0;
+    const unsigned nVars = hdr[0], nPIs = hdr[1], nLatches = hdr[2];
+    const unsigned nAigs = hdr[4];
+    if (hdr[7] || hdr[8]) return -1;  // justice/fairness
+    if (nVars != nPIs + nLatches + nAigs) return 0;
+    const unsigned nPOs = hdr[3] + hdr[5] + hdr[6];  // outputs, bad, constraints
+
+    // latches: next [reset]
+    IdList riLits(nLatches);
+    for (unsigned i = 0; i < nLatches; ++i) {
+        unsigned lits[2], n;
+        if (!in.getLits(lits, 2, n)) return 0;
+        if (n == 2 && lits[1] != 0) return -1;  // reset to 1 or X
+        riLits[i] = lits[0];
+    }
+    IdList poLits(nPOs);
+    for (unsigned i = 0; i < nPOs; ++i) {
+        unsigned n;
+        if (!in.getLits(&poLits[i], 1, n)) return 0;
+    }
+    const unsigned maxLit = 2 * nVars + 1;
+    for (unsigned i = 0; i < nLatches; ++i)
+        if (riLits[i] > maxLit) return 0;
+    for (unsigned i = 0; i < nPOs; ++i)
+        if (poLits[i] > maxLit) return 0;
+
+    // Same ID layout as readCirFromAbc()
+    const unsigned poBegin = nVars + 1, riBegin = poBegin + nPOs;
+    initCir(nPIs, nPOs, nLatches, riBegin + nLatches);
+    _aigList.reserve(nAigs);
+    createConst0();
+    for (unsigned i = 0; i < nPIs; ++i) createInput(i, 1 + i);
+    for (unsigned i = 0; i < nLatches; ++i) createRo(i, 1 + nPIs + i, AIGER);
+    for (unsigned i = 0, lhs = 2 * (nPIs + nLatches + 1); i < nAigs; ++i, lhs += 2) {
+        unsigned d0, d1;
+        if (!in.getDelta(d0) || !in.getDelta(d1)) return 0;
+        if (d0 == 0 || d0 > lhs || d1 > lhs - d0) return 0;
+        const unsigned r0 = lhs - d0, r1 = r0 - d1;
+        createAig(lhs / 2, r0 / 2, r0 & 1, r1 / 2, r1 & 1);
+    }
+    for (unsigned i = 0; i < nPOs; ++i)
+        createOutput(i, poBegin + i, poLits[i] / 2, poLits[i] & 1,
+                     to_string(poBegin + i));
+    for (unsigned i = 0; i < nLatches; ++i) {
+        createRi(i, riBegin + i, riLits[i] / 2, riLits[i] & 1);
+        createRiRo(riBegin + i, 1 + nPIs + i);
+    }
+    createConst1();
+    return 1;
+}
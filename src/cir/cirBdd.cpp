@@ -8,13 +8,14 @@
 
 #include "bddMgrV.h"   // MODIFICATION FOR SoCV BDD
 #include "bddNodeV.h"  // MODIFICATION FOR SoCV BDD
+#include "cirFlat.h"
 #include "cirGate.h"
 #include "cirMgr.h"
 #include "gvMsg.h"
 #include "util.h"
 #include <string>
 
-extern BddMgrV* bddMgrV;  // MODIFICATION FOR SoCV BDD
+extern thread_local BddMgrV* bddMgrV;  // MODIFICATION FOR SoCV BDD
 
 const bool
 CirMgr::setBddOrder(const bool& file) {
@@ -44,8 +45,8 @@ CirMgr::setBddOrder(const bool& file) {
     // here we only create "CS_name + _ns" for y_i
     for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i) {
         CirRiGate* gate = (file) ? getRi(i) : getRi(n - i - 1);
-        bddMgrV->addBddNodeV(gate->getName(), bddMgrV->getSupport(supportId)());
-        bddMgrV->addFddNodeV(gate->getName(), bddMgrV->getSupport(supportId)());
+        bddMgrV->addBddNodeV(getName(gate->getGid()), bddMgrV->getSupport(supportId)());
+        bddMgrV->addFddNodeV(getName(gate->getGid()), bddMgrV->getSupport(supportId)());
         ++supportId;
     }
     // Constants (const0 node, id=0)
@@ -57,24 +58,33 @@ CirMgr::setBddOrder(const bool& file) {
 }
 
 void CirMgr::buildNtkBdd() {
-    // TODO: build BDD for ntk here
-    // Perform DFS traversal from DFF inputs, inout, and output gates.
-    // Collect ordered nets to a GVNetVec
-    // Construct BDDs in the DFS order
-
-    for(unsigned i = 0,n = getNumPOs(); i < n; ++i){
-        // cout << "po" << getPo(i)->getGid() << endl;
-        buildBdd(getPo(i));
+    // Construct BDDs in one sweep over the flat AIG, whose AND gates are
+    // in the DFS order from the POs and RIs
+    const CirFlatAig& aig = getFlatAig();
+    vector<BddNodeV> bdds(aig.getNumObjs());
+    bdds[0] = BddNodeV::_zero;
+    for (unsigned i = 1, n = aig.getAndBegin(); i < n; ++i)
+        bdds[i] = bddMgrV->getBddNodeV(aig.getGid(i));
+    for (unsigned i = aig.getAndBegin(), n = aig.getNumObjs(); i < n; ++i) {
+        FlatLit a = aig.getFanin0(i), b = aig.getFanin1(i);
+        BddNodeV l = bdds[CirFlatAig::litIdx(a)];
+        BddNodeV r = bdds[CirFlatAig::litIdx(b)];
+        if (CirFlatAig::litInv(a)) l = ~l;
+        if (CirFlatAig::litInv(b)) r = ~r;
+        bdds[i] = l & r;
+        bddMgrV->addBddNodeV(aig.getGid(i), bdds[i]());
     }
-    for(unsigned i = 0,n = getNumPIs(); i < n; ++i){
-        // cout << "pi" << getPi(i)->getGid() << endl;
-        buildBdd(getPi(i));
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i) {
+        FlatLit a  = aig.getPoLit(i);
+        BddNodeV l = bdds[CirFlatAig::litIdx(a)];
+        if (CirFlatAig::litInv(a)) l = ~l;
+        bddMgrV->addBddNodeV(getPo(i)->getGid(), l());
     }
-    for(unsigned i = 0,n = getNumLATCHs(); i < n; ++i){
-        // cout << "ro" << getRo(i)->getGid() << endl;
-        buildBdd(getRo(i));
-        // cout << "ri" << getRi(i)->getGid() << endl;
-        buildBdd(getRi(i));
+    for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i) {
+        FlatLit a  = aig.getRiLit(i);
+        BddNodeV l = bdds[CirFlatAig::litIdx(a)];
+        if (CirFlatAig::litInv(a)) l = ~l;
+        bddMgrV->addBddNodeV(getRi(i)->getGid(), l());
     }
 }
 
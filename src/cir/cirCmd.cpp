@@ -31,13 +31,16 @@ bool initCirCmd() {
     return (gvCmdMgr->regCmd("CIRRead", 4, new CirReadCmd) &&
             gvCmdMgr->regCmd("CIRPrint", 4, new CirPrintCmd) &&
             gvCmdMgr->regCmd("CIRGate", 4, new CirGateCmd) &&
-            // gvCmdMgr->regCmd("CIRSWeep", 5, new CirSweepCmd) &&
-            // gvCmdMgr->regCmd("CIROPTimize", 6, new CirOptCmd) &&
-            // gvCmdMgr->regCmd("CIRSTRash", 6, new CirStrashCmd) &&
+            gvCmdMgr->regCmd("CIRSWeep", 5, new CirSweepCmd) &&
+            gvCmdMgr->regCmd("CIROPTimize", 6, new CirOptCmd) &&
+            gvCmdMgr->regCmd("CIRSTRash", 6, new CirStrashCmd) &&
+            gvCmdMgr->regCmd("CIRREWrite", 6, new CirRewriteCmd) &&
             gvCmdMgr->regCmd("CIRSIMulate", 6, new CirSimCmd) &&
-            // gvCmdMgr->regCmd("CIRFraig", 4, new CirFraigCmd) &&
+            gvCmdMgr->regCmd("CIRFraig", 4, new CirFraigCmd) &&
+            gvCmdMgr->regCmd("CIRMiter", 4, new CirMiterCmd) &&
+            gvCmdMgr->regCmd("CIRLCorr", 5, new CirLCorrCmd) &&
+            gvCmdMgr->regCmd("CIRTERsim", 6, new CirTerSimCmd) &&
             // gvCmdMgr->regCmd("CIRWrite", 4, new CirWriteCmd) &&
-            // gvCmdMgr->regCmd("CIRMiter", 4, new CirMiterCmd) &&
             // gvCmdMgr->regCmd("CIREFFort", 6, new CirEffortCmd));
             gvCmdMgr->regCmd("CIRGate", 4, new CirGateCmd) &&
             gvCmdMgr->regCmd("CIRWrite", 4, new CirWriteCmd));
@@ -47,9 +50,11 @@ enum CirCmdState {
     // Order matters! Do not change the order!!
     CIRINIT,
     CIRREAD,
+    CIRSWEEP,
     CIROPT,
     CIRSTRASH,
     CIRSIMULATE,
+    CIRFRAIG,
     // dummy end
     CIRCMDTOT
 };
@@ -113,7 +118,9 @@ GVCmdExecStatus CirReadCmd::exec(const string& option) {
     if (fileType == BLIF) {
         cirMgr->readBlif(fileName);
     } else {
-        if (!cirMgr->readCirFromAbc(fileName, fileType)) {
+        bool ok = (fileType == AIGER) ? cirMgr->readAig(fileName)
+                                      : cirMgr->readCirFromAbc(fileName, fileType);
+        if (!ok) {
             delete cirMgr;
             cirMgr = 0;
         }
@@ -135,7 +142,8 @@ void CirReadCmd::help() const {
 }
 
 //----------------------------------------------------------------------
-//    CIRPrint [-Summary | -Netlist | -PI | -PO | -FLoating | -FECpairs]
+//    CIRPrint [-Summary | -Netlist | -PI | -PO | -FLoating | -FECpairs
+//              | -Levels]
 //----------------------------------------------------------------------
 GVCmdExecStatus
 CirPrintCmd::exec(const string& option) {
@@ -147,6 +155,7 @@ CirPrintCmd::exec(const string& option) {
         cerr << "Error: circuit is not yet constructed!!" << endl;
         return GV_CMD_EXEC_ERROR;
     }
+    cirMgr->updateDfsList();
     if (token.empty() || myStrNCmp("-Summary", token, 2) == 0)
         cirMgr->printSummary();
     else if (myStrNCmp("-Netlist", token, 2) == 0)
@@ -159,6 +168,8 @@ CirPrintCmd::exec(const string& option) {
         cirMgr->printFloatGates();
     else if (myStrNCmp("-FECpairs", token, 4) == 0)
         cirMgr->printFECPairs();
+    else if (myStrNCmp("-Levels", token, 2) == 0)
+        cirMgr->printLevels();
     else
         return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, token);
 
@@ -166,7 +177,8 @@ CirPrintCmd::exec(const string& option) {
 }
 
 void CirPrintCmd::usage(const bool& verbose) const {
-    cout << "Usage: CIRPrint [-Summary | -Netlist | -PI | -PO | -FLoating | -FECpairs]" << endl;
+    cout << "Usage: CIRPrint [-Summary | -Netlist | -PI | -PO | -FLoating | -FECpairs\n"
+         << "                 | -Levels]" << endl;
 }
 
 void CirPrintCmd::help() const {
@@ -252,7 +264,8 @@ void CirGateCmd::help() const {
 }
 
 //----------------------------------------------------------------------
-//    CIRWrite <-Aag [(int gateId)] | -Aig | -Blif> <-Output (string fileName)>
+//    CIRWrite <-Aag [(int gateId)] | -Aiger | -Blif> <-Output (string fileName)>
+//             [-Gzip]
 //----------------------------------------------------------------------
 GVCmdExecStatus
 CirWriteCmd::exec(const string& option) {
@@ -264,16 +277,19 @@ CirWriteCmd::exec(const string& option) {
     vector<string> options;
     GVCmdExec::lexOptions(option, options);
 
+    cirMgr->updateDfsList();
     if (options.empty()) {
-        cirMgr->writeAag(cout);
+        if (!cirMgr->writeAag(cout)) {
+            cerr << "Error: failed to write the circuit!!" << endl;
+            return GV_CMD_EXEC_ERROR;
+        }
         return GV_CMD_EXEC_DONE;
     }
-    FileType fileType;
-    bool hasFile = false;
+    FileType fileType = AAG;
+    bool hasFile = false, gzip = false;
     int gateId;
     CirGate* thisGate = NULL;
     string outFileName;
-    ofstream outfile;
     for (size_t i = 0, n = options.size(); i < n; ++i) {
         if (myStrNCmp("-Aiger", options[i], 2) == 0) {
             fileType = AIGER;
@@ -281,16 +297,15 @@ CirWriteCmd::exec(const string& option) {
             fileType = AAG;
         } else if (myStrNCmp("-Blif", options[i], 2) == 0) {
             fileType = BLIF;
+        } else if (myStrNCmp("-Gzip", options[i], 2) == 0) {
+            gzip = true;
         } else if (myStrNCmp("-Output", options[i], 2) == 0) {
             if (hasFile)
                 return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
             if (++i == n)
                 return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[i - 1]);
-            outFileName = options[i].c_str();
-            outfile.open(options[i].c_str(), ios::out);
-            if (!outfile)
-                return GVCmdExec::errorOption(GV_CMD_OPT_FOPEN_FAIL, options[1]);
-            hasFile = true;
+            outFileName = options[i];
+            hasFile     = true;
             cirMgr->setFileName(outFileName);
         } else if (myStr2Int(options[i], gateId) && gateId >= 0) {
             if (fileType != AAG)
@@ -311,21 +326,18 @@ CirWriteCmd::exec(const string& option) {
 
     if (!hasFile) return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, "-Output");
 
-    cout << outFileName << "\n";
-    if (fileType == BLIF) yosysMgr->writeBlif(outFileName);
-    else if (fileType == AIGER) yosysMgr->writeAiger(outFileName);
-    else {
-        if (!thisGate) {
-            assert(hasFile);
-            cirMgr->writeAag(outfile);
-        } else if (hasFile) cirMgr->writeGate(outfile, thisGate);
-        else cirMgr->writeGate(cout, thisGate);
-    }
+    if (thisGate && fileType != AAG)
+        return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, to_string(gateId));
+    const size_t len = outFileName.size();
+    if (len > 3 && outFileName.compare(len - 3, 3, ".gz") == 0) gzip = true;
+    if (!cirMgr->writeFile(outFileName, fileType, gzip, thisGate))
+        return GV_CMD_EXEC_ERROR;
     return GV_CMD_EXEC_DONE;
 }
 
 void CirWriteCmd::usage(const bool& verbose) const {
-    cout << "Usage: CIRWrite <-Aag [(int gateId)] | -Aig | -Blif> <-Output (string fileName)>" << endl;
+    cout << "Usage: CIRWrite <-Aag [(int gateId)] | -Aiger | -Blif> <-Output (string fileName)>" << endl;
+    cout << "                [-Gzip]" << endl;
 }
 
 void CirWriteCmd::help() const {
@@ -333,104 +345,148 @@ void CirWriteCmd::help() const {
          << "Write the netlist to an AIG/AAG/BLIF file\n";
 }
 
-// void
-// CirSweepCmd::help() const
-// {
-//    cout << setw(15) << left << "CIRSWeep: "
-//         << "remove unused gates\n";
-// }
+//----------------------------------------------------------------------
+//    CIRSWeep
+//----------------------------------------------------------------------
+GVCmdExecStatus
+CirSweepCmd::exec(const string& option) {
+    if (!cirMgr) {
+        cerr << "Error: circuit is not yet constructed!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    // check option
+    vector<string> options;
+    GVCmdExec::lexOptions(option, options);
+    if (!options.empty())
+        return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[0]);
 
-// //----------------------------------------------------------------------
-// //    CIROPTimize
-// //----------------------------------------------------------------------
-// GVCmdExecStatus
-// CirOptCmd::exec(const string& option)
-// {
-//    if (!cirMgr) {
-//       cerr << "Error: circuit is not yet constructed!!" << endl;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-//    // check option
-//    vector<string> options;
-//    GVCmdExec::lexOptions(option, options);
+    assert(curCmd != CIRINIT);
+    cirMgr->sweep();
+    curCmd = CIRSWEEP;
 
-//    if (!options.empty())
-//       return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[0]);
+    return GV_CMD_EXEC_DONE;
+}
 
-//    assert(curCmd != CIRINIT);
-//    if (curCmd == CIRSIMULATE) {
-//       cerr << "Error: circuit has been simulated!! Do \"CIRFraig\" first!!"
-//            << endl;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-//    cirMgr->optimize();
-//    curCmd = CIROPT;
+void CirSweepCmd::usage(const bool& verbose) const {
+    cout << "Usage: CIRSWeep" << endl;
+}
 
-//    return GV_CMD_EXEC_DONE;
-// }
+void CirSweepCmd::help() const {
+    cout << setw(20) << left << "CIRSWeep: "
+         << "Remove the gates unreachable from the outputs\n";
+}
 
-// void
-// CirOptCmd::usage(const bool& verbose) const
-// {
-//    cout << "Usage: CIROPTimize" << endl;
-// }
+//----------------------------------------------------------------------
+//    CIROPTimize
+//----------------------------------------------------------------------
+GVCmdExecStatus
+CirOptCmd::exec(const string& option) {
+    if (!cirMgr) {
+        cerr << "Error: circuit is not yet constructed!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    // check option
+    vector<string> options;
+    GVCmdExec::lexOptions(option, options);
+    if (!options.empty())
+        return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[0]);
 
-// void
-// CirOptCmd::help() const
-// {
-//    cout << setw(15) << left << "CIROPTimize: "
-//         << "perform trivial optimizations\n";
-// }
+    assert(curCmd != CIRINIT);
+    if (curCmd == CIRSIMULATE) {
+        cerr << "Error: circuit has been simulated!! Do \"CIRFraig\" first!!"
+             << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    cirMgr->optimize();
+    curCmd = CIROPT;
 
-// //----------------------------------------------------------------------
-// //    CIRSTRash
-// //----------------------------------------------------------------------
-// GVCmdExecStatus
-// CirStrashCmd::exec(const string& option)
-// {
-//    if (!cirMgr) {
-//       cerr << "Error: circuit is not yet constructed!!" << endl;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-//    // check option
-//    vector<string> options;
-//    GVCmdExec::lexOptions(option, options);
+    return GV_CMD_EXEC_DONE;
+}
 
-//    if (!options.empty())
-//       return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[0]);
+void CirOptCmd::usage(const bool& verbose) const {
+    cout << "Usage: CIROPTimize" << endl;
+}
 
-//    assert(curCmd != CIRINIT);
-//    if (curCmd == CIRSTRASH) {
-//       cerr << "Error: circuit has been strashed!!" << endl;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-//    else if (curCmd == CIRSIMULATE) {
-//       cerr << "Error: circuit has been simulated!! Do \"CIRFraig\" first!!"
-//            << endl;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-//    cirMgr->strash();
-//    curCmd = CIRSTRASH;
+void CirOptCmd::help() const {
+    cout << setw(20) << left << "CIROPTimize: "
+         << "Perform trivial optimizations on the circuit\n";
+}
 
-//    return GV_CMD_EXEC_DONE;
-// }
+//----------------------------------------------------------------------
+//    CIRSTRash
+//----------------------------------------------------------------------
+GVCmdExecStatus
+CirStrashCmd::exec(const string& option) {
+    if (!cirMgr) {
+        cerr << "Error: circuit is not yet constructed!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    // check option
+    vector<string> options;
+    GVCmdExec::lexOptions(option, options);
+    if (!options.empty())
+        return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[0]);
 
-// void
-// CirStrashCmd::usage(const bool& verbose) const
-// {
-//    cout << "Usage: CIRSTRash" << endl;
-// }
+    assert(curCmd != CIRINIT);
+    if (curCmd == CIRSTRASH) {
+        cerr << "Error: circuit has been strashed!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    } else if (curCmd == CIRSIMULATE) {
+        cerr << "Error: circuit has been simulated!! Do \"CIRFraig\" first!!"
+             << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    cirMgr->strash();
+    curCmd = CIRSTRASH;
 
-// void
-// CirStrashCmd::help() const
-// {
-//    cout << setw(15) << left << "CIRSTRash: "
-//         << "perform structural hash on the circuit netlist\n";
-// }
+    return GV_CMD_EXEC_DONE;
+}
+
+void CirStrashCmd::usage(const bool& verbose) const {
+    cout << "Usage: CIRSTRash" << endl;
+}
+
+void CirStrashCmd::help() const {
+    cout << setw(20) << left << "CIRSTRash: "
+         << "Merge the structurally equivalent gates\n";
+}
+
+//----------------------------------------------------------------------
+//    CIRREWrite
+//----------------------------------------------------------------------
+GVCmdExecStatus
+CirRewriteCmd::exec(const string& option) {
+    if (!cirMgr) {
+        cerr << "Error: circuit is not yet constructed!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    // check option
+    vector<string> options;
+    GVCmdExec::lexOptions(option, options);
+    if (!options.empty())
+        return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[0]);
+
+    assert(curCmd != CIRINIT);
+    cirMgr->rewrite();
+    curCmd = CIROPT;
+
+    return GV_CMD_EXEC_DONE;
+}
+
+void CirRewriteCmd::usage(const bool& verbose) const {
+    cout << "Usage: CIRREWrite" << endl;
+}
+
+void CirRewriteCmd::help() const {
+    cout << setw(20) << left << "CIRREWrite: "
+         << "Rewrite the 4-input cuts with smaller AIG structures\n";
+}
 
 //----------------------------------------------------------------------
-//    CIRSIMulate <-Random | -File <string patternFile>>
-//                [-Output (string logFile)]
+//    CIRSIMulate <-Random [-Threads (int numThreads)]
+//                         [-Cycles (int numCycles) [-Monitor (int outputIndex)]]
+//                | -File <string patternFile> [-Event]>
+//                [-Output (string logFile)] [-Profile]
 //----------------------------------------------------------------------
 GVCmdExecStatus
 CirSimCmd::exec(const string& option) {
@@ -444,7 +500,9 @@ CirSimCmd::exec(const string& option) {
 
     ifstream patternFile;
     ofstream logFile;
-    bool doRandom = false, doFile = false, doLog = false;
+    bool doRandom = false, doFile = false, doLog = false, doProfile = false;
+    bool doEvent = false;
+    int nThreads = 0, nCycles = 0, monitor = -1;
     for (size_t i = 0, n = options.size(); i < n; ++i) {
         if (myStrNCmp("-Random", options[i], 2) == 0) {
             if (doRandom || doFile)
@@ -468,31 +526,81 @@ CirSimCmd::exec(const string& option) {
             if (!logFile)
                 return GVCmdExec::errorOption(GV_CMD_OPT_FOPEN_FAIL, options[i]);
             doLog = true;
+        } else if (myStrNCmp("-Threads", options[i], 2) == 0) {
+            if (nThreads)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            if (++i == n)
+                return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[i - 1]);
+            if (!myStr2Int(options[i], nThreads) || nThreads <= 0)
+                return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+        } else if (myStrNCmp("-Cycles", options[i], 2) == 0) {
+            if (nCycles)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            if (++i == n)
+                return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[i - 1]);
+            if (!myStr2Int(options[i], nCycles) || nCycles <= 0)
+                return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+        } else if (myStrNCmp("-Monitor", options[i], 2) == 0) {
+            if (monitor >= 0)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            if (++i == n)
+                return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[i - 1]);
+            if (!myStr2Int(options[i], monitor) || monitor < 0 ||
+                unsigned(monitor) >= cirMgr->getNumPOs())
+                return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+        } else if (myStrNCmp("-Event", options[i], 2) == 0) {
+            if (doEvent)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            doEvent = true;
+        } else if (myStrNCmp("-Profile", options[i], 2) == 0) {
+            if (doProfile)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            doProfile = true;
         } else
             return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
     }
 
     if (!doRandom && !doFile)
         return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, "");
+    if ((nThreads || nCycles) && !doRandom) {
+        cerr << "Error: -Threads and -Cycles are only supported with -Random!!"
+             << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    if (doEvent && !doFile) {
+        cerr << "Error: -Event is only supported with -File!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    if (monitor >= 0 && !nCycles)
+        return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, "-Cycles");
 
     assert(curCmd != CIRINIT);
     if (doLog)
         cirMgr->setSimLog(&logFile);
     else cirMgr->setSimLog(0);
+    cirMgr->setSimProfile(doProfile);
+    cirMgr->setSimEvent(doEvent);
 
-    if (doRandom)
-        cirMgr->randomSim();
+    if (nCycles)
+        cirMgr->seqSim(nCycles, monitor, nThreads ? nThreads : 1);
+    else if (doRandom)
+        cirMgr->randomSim(nThreads ? nThreads : 1);
     else
         cirMgr->fileSim(patternFile);
     cirMgr->setSimLog(0);
+    cirMgr->setSimProfile(false);
+    cirMgr->setSimEvent(false);
     curCmd = CIRSIMULATE;
 
     return GV_CMD_EXEC_DONE;
 }
 
 void CirSimCmd::usage(const bool& verbose) const {
-    cout << "Usage: CIRSIMulate <-Random | -File <string patternFile>>\n"
-         << "                   [-Output (string logFile)]" << endl;
+    cout << "Usage: CIRSIMulate <-Random [-Threads (int numThreads)]\n"
+         << "                            [-Cycles (int numCycles) "
+         << "[-Monitor (int outputIndex)]]\n"
+         << "                   | -File <string patternFile> [-Event]>\n"
+         << "                   [-Output (string logFile)] [-Profile]" << endl;
 }
 
 void CirSimCmd::help() const {
@@ -500,45 +608,290 @@ void CirSimCmd::help() const {
          << "Perform Boolean logic simulation on the circuit\n";
 }
 
-// //----------------------------------------------------------------------
-// //    CIRFraig
-// //----------------------------------------------------------------------
-// GVCmdExecStatus
-// CirFraigCmd::exec(const string& option)
-// {
-//    if (!cirMgr) {
-//       cerr << "Error: circuit is not yet constructed!!" << endl;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-//    // check option
-//    vector<string> options;
-//    GVCmdExec::lexOptions(option, options);
+//----------------------------------------------------------------------
+//    CIRFraig
+//----------------------------------------------------------------------
+GVCmdExecStatus
+CirFraigCmd::exec(const string& option) {
+    if (!cirMgr) {
+        cerr << "Error: circuit is not yet constructed!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    // check option
+    vector<string> options;
+    GVCmdExec::lexOptions(option, options);
+    if (!options.empty())
+        return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[0]);
 
-//    if (!options.empty())
-//       return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[0]);
+    assert(curCmd != CIRINIT);
+    cirMgr->fraig();
+    curCmd = CIRFRAIG;
 
-//    if (curCmd != CIRSIMULATE) {
-//       cerr << "Error: circuit is not yet simulated!!" << endl;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-//    cirMgr->fraig();
-//    curCmd = CIRFRAIG;
+    return GV_CMD_EXEC_DONE;
+}
 
-//    return GV_CMD_EXEC_DONE;
-// }
+void CirFraigCmd::usage(const bool& verbose) const {
+    cout << "Usage: CIRFraig" << endl;
+}
 
-// void
-// CirFraigCmd::usage(const bool& verbose) const
-// {
-//    cout << "Usage: CIRFraig" << endl;
-// }
+void CirFraigCmd::help() const {
+    cout << setw(20) << left << "CIRFraig: "
+         << "Merge the functionally equivalent gates by simulation and SAT\n";
+}
 
-// void
-// CirFraigCmd::help() const
-// {
-//    cout << setw(15) << left << "CIRFraig: "
-//         << "perform Boolean logic simulation on the circuit\n";
-// }
+//----------------------------------------------------------------------
+//    CIRMiter <(string inFile1)> <(string inFile2)> [-Latch]
+//             [-Cycles (int numCycles)] [-Assert]
+//----------------------------------------------------------------------
+GVCmdExecStatus
+CirMiterCmd::exec(const string& option) {
+    // check option
+    vector<string> options;
+    GVCmdExec::lexOptions(option, options);
+
+    bool pairLatches = false, assertEq = false;
+    int nCycles      = 0;
+    vector<string> files;
+    for (size_t i = 0, n = options.size(); i < n; ++i) {
+        if (myStrNCmp("-Latch", options[i], 2) == 0) {
+            if (pairLatches) return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            pairLatches = true;
+        } else if (myStrNCmp("-Assert", options[i], 2) == 0) {
+            if (assertEq) return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            assertEq = true;
+        } else if (myStrNCmp("-Cycles", options[i], 2) == 0) {
+            if (nCycles)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            if (++i == n)
+                return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[i - 1]);
+            if (!myStr2Int(options[i], nCycles) || nCycles <= 0)
+                return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+        } else if (files.size() == 2) {
+            return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+        } else {
+            const string& f = options[i];
+            if ((f.size() < 3 || f.compare(f.size() - 2, 2, ".v") != 0) &&
+                (f.size() < 5 || f.compare(f.size() - 4, 4, ".aig") != 0))
+                return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, f);
+            files.push_back(f);
+        }
+    }
+    if (files.size() < 2)
+        return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, files.empty() ? "" : files[0]);
+    if (pairLatches && nCycles) {
+        cerr << "Error: -Cycles is only supported without -Latch!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+
+    if (cirMgr != 0) {
+        cerr << "Note: original circuit is replaced..." << endl;
+        curCmd = CIRINIT;
+        delete cirMgr;
+        cirMgr = 0;
+    }
+    // The readers build into the global cirMgr
+    CirMgr* cm[2] = {0, 0};
+    for (int i = 0; i < 2; ++i) {
+        cirMgr = cm[i] = new CirMgr;
+        const bool isAig = files[i].compare(files[i].size() - 4, 4, ".aig") == 0;
+        if (!(isAig ? cm[i]->readAig(files[i])
+                    : cm[i]->readCirFromAbc(files[i], VERILOG))) {
+            for (int j = 0; j <= i; ++j) delete cm[j];
+            cirMgr = 0;
+            return GV_CMD_EXEC_ERROR;
+        }
+    }
+
+    cirMgr = new CirMgr;
+    if (!cirMgr->createMiter(cm[0], cm[1], pairLatches)) {
+        delete cirMgr;
+        cirMgr = 0;
+    }
+    delete cm[0];
+    delete cm[1];
+    if (!cirMgr) return GV_CMD_EXEC_ERROR;
+    curCmd = CIRREAD;
+
+    bool equiv;
+    if (pairLatches) equiv = cirMgr->checkMiter(0);
+    else if (nCycles) equiv = cirMgr->checkMiter(nCycles);
+    else equiv = cirMgr->checkMiter();
+    curCmd = CIRFRAIG;
+    // A regression dofile has no other way to fail the run
+    if (assertEq && !equiv) {
+        cerr << "Error: the two circuits are not proved equivalent!!" << endl;
+        exit(1);
+    }
+    return GV_CMD_EXEC_DONE;
+}
+
+void CirMiterCmd::usage(const bool& verbose) const {
+    cout << "Usage: CIRMiter <(string inFile1)> <(string inFile2)> [-Latch]" << endl;
+    cout << "                [-Cycles (int numCycles)] [-Assert]" << endl;
+    cout << "Without -Latch, the latches of both circuits are kept, and those\n"
+         << "proved equivalent by latch correspondence (CIRLCorr) are merged.\n"
+         << "An output that still depends on the latches is checked only by BMC\n"
+         << "from reset for numCycles (default 10) cycles: it is disproved or\n"
+         << "\"unknown (needs -Latch pairing)\", never proved.\n"
+         << "-Latch pairs the latches and also checks their next states; an\n"
+         << "output that depends on an unpaired latch is only \"not proved\".\n"
+         << "-Assert exits GV with status 1 unless the circuits are proved\n"
+         << "equivalent, e.g. to check a regression dofile."
+         << endl;
+}
+
+void CirMiterCmd::help() const {
+    cout << setw(20) << left << "CIRMiter: "
+         << "Build the miter of two circuits and check their equivalence\n";
+}
+
+//----------------------------------------------------------------------
+//    CIRLCorr [-Depth (int depth)] [-Cycles (int numCycles)]
+//----------------------------------------------------------------------
+GVCmdExecStatus
+CirLCorrCmd::exec(const string& option) {
+    if (!cirMgr) {
+        cerr << "Error: circuit is not yet constructed!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    // check option
+    vector<string> options;
+    GVCmdExec::lexOptions(option, options);
+
+    int depth = 0, nCycles = 0;
+    for (size_t i = 0, n = options.size(); i < n; ++i) {
+        if (myStrNCmp("-Depth", options[i], 2) == 0) {
+            if (depth)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            if (++i == n)
+                return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[i - 1]);
+            if (!myStr2Int(options[i], depth) || depth <= 0)
+                return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+        } else if (myStrNCmp("-Cycles", options[i], 2) == 0) {
+            if (nCycles)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            if (++i == n)
+                return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[i - 1]);
+            if (!myStr2Int(options[i], nCycles) || nCycles <= 0)
+                return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+        } else
+            return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+    }
+
+    assert(curCmd != CIRINIT);
+    cirMgr->latchCorr(depth ? depth : 1, nCycles ? nCycles : 64);
+    curCmd = CIROPT;
+
+    return GV_CMD_EXEC_DONE;
+}
+
+void CirLCorrCmd::usage(const bool& verbose) const {
+    cout << "Usage: CIRLCorr [-Depth (int depth)] [-Cycles (int numCycles)]"
+         << endl;
+}
+
+void CirLCorrCmd::help() const {
+    cout << setw(20) << left << "CIRLCorr: "
+         << "Merge the equivalent and constant latches by induction\n";
+}
+
+//----------------------------------------------------------------------
+//    CIRTERsim [-Cycles (int numCycles)] [-Random]
+//              [-Xinit | -Init <(string 01X) | (string initFile)>]
+//----------------------------------------------------------------------
+GVCmdExecStatus
+CirTerSimCmd::exec(const string& option) {
+    if (!cirMgr) {
+        cerr << "Error: circuit is not yet constructed!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    // check option
+    vector<string> options;
+    GVCmdExec::lexOptions(option, options);
+
+    int nCycles = 0;
+    bool xInit = false, doInit = false, randPIs = false;
+    string init;  // '0', '1' or 'X' for each latch; empty for reset
+    for (size_t i = 0, n = options.size(); i < n; ++i) {
+        if (myStrNCmp("-Cycles", options[i], 2) == 0) {
+            if (nCycles)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            if (++i == n)
+                return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[i - 1]);
+            if (!myStr2Int(options[i], nCycles) || nCycles <= 0)
+                return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+        } else if (myStrNCmp("-Xinit", options[i], 2) == 0) {
+            if (xInit || doInit)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            xInit = true;
+        } else if (myStrNCmp("-Init", options[i], 2) == 0) {
+            if (xInit || doInit)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            if (++i == n)
+                return GVCmdExec::errorOption(GV_CMD_OPT_MISSING, options[i - 1]);
+            // a string of 0/1/X, or else a file of them (blanks ignored)
+            if (options[i].find_first_not_of("01Xx") == string::npos)
+                init = options[i];
+            else {
+                ifstream initFile(options[i].c_str(), ios::in);
+                if (!initFile)
+                    return GVCmdExec::errorOption(GV_CMD_OPT_FOPEN_FAIL, options[i]);
+                char c;
+                while (initFile >> c) init.push_back(c);
+            }
+            for (size_t j = 0; j < init.size(); ++j) {
+                if (init[j] == 'x') init[j] = 'X';
+                if (init[j] != '0' && init[j] != '1' && init[j] != 'X') {
+                    cerr << "Error: illegal initial value \'" << init[j]
+                         << "\' (must be 0, 1 or X)!!" << endl;
+                    return GV_CMD_EXEC_ERROR;
+                }
+            }
+            if (init.size() != cirMgr->getNumLATCHs()) {
+                cerr << "Error: " << init.size() << " initial values for "
+                     << cirMgr->getNumLATCHs() << " latches!!" << endl;
+                return GV_CMD_EXEC_ERROR;
+            }
+            doInit = true;
+        } else if (myStrNCmp("-Random", options[i], 2) == 0) {
+            if (randPIs)
+                return GVCmdExec::errorOption(GV_CMD_OPT_EXTRA, options[i]);
+            randPIs = true;
+        } else
+            return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+    }
+
+    // The random PIs are binary, so X can only come from the latches:
+    // -Random starts from all latches X unless -Init gives some X
+    if (randPIs && !doInit) xInit = true;
+    if (randPIs && doInit && init.find('X') == string::npos) {
+        cerr << "Error: -Random needs some X in the initial state!!" << endl;
+        return GV_CMD_EXEC_ERROR;
+    }
+    if (xInit) init.assign(cirMgr->getNumLATCHs(), 'X');
+
+    assert(curCmd != CIRINIT);
+    if (!nCycles) nCycles = randPIs ? 64 : 1024;
+    cirMgr->ternarySim(nCycles, init, randPIs);
+
+    return GV_CMD_EXEC_DONE;
+}
+
+void CirTerSimCmd::usage(const bool& verbose) const {
+    cout << "Usage: CIRTERsim [-Cycles (int numCycles)] [-Random]" << endl;
+    cout << "                 [-Xinit | -Init <(string 01X) | (string initFile)>]"
+         << endl;
+    cout << "The simulation starts from reset (all latches 0), from all latches\n"
+         << "X (-Xinit), or from one 0, 1 or X per latch in latch order (-Init,\n"
+         << "given directly or in a file). -Random drives random binary PIs, so\n"
+         << "it needs some X latch and implies -Xinit when -Init is not given."
+         << endl;
+}
+
+void CirTerSimCmd::help() const {
+    cout << setw(20) << left << "CIRTERsim: "
+         << "Ternary (0/1/X) simulation for reset and X-propagation analysis\n";
+}
 
 // //----------------------------------------------------------------------
 // //    CIRWrite [(int gateId)][-Output (string aagFile)]
@@ -612,70 +965,6 @@ void CirSimCmd::help() const {
 //         << "write the netlist to an ASCII AIG file (.aag)\n";
 // }
 
-// //----------------------------------------------------------------------
-// //    CIRMiter <(string inFile1)> <(string inFile2)>
-// //----------------------------------------------------------------------
-// GVCmdExecStatus
-// CirMiterCmd::exec(const string& option)
-// {
-//    // check option
-//    vector<string> options;
-//    GVCmdExec::lexOptions(option, options);
-
-//    if (cirMgr != 0) {
-//       cerr << "Note: original circuit is replaced..." << endl;
-//       curCmd = CIRINIT;
-//       delete cirMgr; cirMgr = 0;
-//    }
-//    CirMgr *cm[2];
-//    for (int i = 0; i < 2; ++i) {
-//       cm[i] = new CirMgr;
-//       cirMgr = cm[i];
-//       if (!cirMgr->readCircuit(options[i])) {
-//          curCmd = CIRINIT;
-//          for (int j = 0; j <= i; ++j) delete cm[j];
-//          cirMgr = 0;
-//          return GV_CMD_EXEC_ERROR;
-//       }
-//    }
-
-//    if (cm[0]->getNumPIs() != cm[1]->getNumPIs()) {
-//       cerr << "Error: numbers of PIs are different!!" << endl;
-//       delete cm[0]; delete cm[1]; cirMgr = 0;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-//    if (cm[0]->getNumPOs() != cm[1]->getNumPOs()) {
-//       cerr << "Error: numbers of POs are different!!" << endl;
-//       delete cm[0]; delete cm[1]; cirMgr = 0;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-
-//    cirMgr = new CirMgr;
-//    if (!cirMgr->createMiter(cm[0], cm[1])) {
-//       delete cirMgr;
-//       cirMgr = 0;
-//       return GV_CMD_EXEC_ERROR;
-//    }
-//    delete cm[0]; delete cm[1];
-
-//    curCmd = CIRREAD;
-
-//    return GV_CMD_EXEC_DONE;
-// }
-
-// void
-// CirMiterCmd::usage(const bool& verbose) const
-// {
-//    cout << "Usage: CIRMiter <(string inFile1)> <(string inFile2)> " << endl;
-// }
-
-// void
-// CirMiterCmd::help() const
-// {
-//    cout << setw(15) << left << "CIRMiter: "
-//         << "create a miter circuit.\n";
-// }
-
 // //----------------------------------------------------------------------
 // //    CIREFFort <(int effortLimit)>
 // //----------------------------------------------------------------------
@@ -16,11 +16,14 @@ GV_COMMAND(CirPrintCmd, GV_CMD_TYPE_NETWORK);
 GV_COMMAND(CirGateCmd, GV_CMD_TYPE_NETWORK);
 GV_COMMAND(CirWriteCmd, GV_CMD_TYPE_NETWORK);
 GV_COMMAND(CirSimCmd, GV_CMD_TYPE_NETWORK);
-// GV_COMMAND(CirSweepCmd, GV_CMD_TYPE_NETWORK);
-// GV_COMMAND(CirOptCmd, GV_CMD_TYPE_NETWORK);
-// GV_COMMAND(CirStrashCmd, GV_CMD_TYPE_NETWORK);
-// GV_COMMAND(CirFraigCmd, GV_CMD_TYPE_NETWORK);
-// GV_COMMAND(CirMiterCmd, GV_CMD_TYPE_NETWORK);
+GV_COMMAND(CirSweepCmd, GV_CMD_TYPE_NETWORK);
+GV_COMMAND(CirOptCmd, GV_CMD_TYPE_NETWORK);
+GV_COMMAND(CirStrashCmd, GV_CMD_TYPE_NETWORK);
+GV_COMMAND(CirFraigCmd, GV_CMD_TYPE_NETWORK);
+GV_COMMAND(CirRewriteCmd, GV_CMD_TYPE_NETWORK);
+GV_COMMAND(CirMiterCmd, GV_CMD_TYPE_NETWORK);
+GV_COMMAND(CirLCorrCmd, GV_CMD_TYPE_NETWORK);
+GV_COMMAND(CirTerSimCmd, GV_CMD_TYPE_NETWORK);
 // GV_COMMAND(CirEffortCmd, GV_CMD_TYPE_NETWORK);
 
 #endif  // CIR_CMD_H
@@ -1,68 +1,322 @@
-// /****************************************************************************
-//   FileName     [ cirCut.cpp ]
-//   PackageName  [ cir ]
-//   Synopsis     [ Define cir cut functions ]
-//   Author       [ Chung-Yang (Ric) Huang ]
-//   Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
-// ****************************************************************************/
-
-#ifndef CIR_CUT_CPP
-#define CIR_CUT_CPP
+/****************************************************************************
+  FileName     [ cirCut.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define cir cut functions ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
 
 #include "cirCut.h"
 
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 
+#include "cirGate.h"
 #include "util.h"
 
 using namespace std;
 
-/************************************************/
-/*   Public member functions about Simulation   */
-/************************************************/
-
-// enrumerate the k-feasible cuts at the node
-vector<CirCut*>
-CirCutMan::gateGetCuts(CirGate* root, int k) {
-    if (root->isGlobalRef()) return gate2Cut[root];
-    root->setToGlobalRef();
-    vector<CirCut*> rootCuts;
-    CirCut* rootCut;
-    rootCut            = new CirCut;
-    rootCut->cutSize   = 1;
-    rootCut->leafNodes = {root};
-    rootCuts.push_back(rootCut);
-
-    if (root->getType() == AIG_GATE) {
-        vector<CirCut*> leftCuts, rightCuts;
-        leftCuts  = gateGetCuts(root->getIn0Gate(), k);
-        rightCuts = gateGetCuts(root->getIn1Gate(), k);
-        for (int i = 0; i < leftCuts.size(); ++i) {
-            for (int j = 0; j < rightCuts.size(); ++j) {
-                int cutSize = leftCuts[i]->cutSize + rightCuts[j]->cutSize;
-                if (cutSize > k) continue;
-                rootCut          = new CirCut;
-                rootCut->cutSize = cutSize;
-
-                // insert left/right nodes cut
-                rootCut->leafNodes.insert(rootCut->leafNodes.end(), leftCuts[i]->leafNodes.begin(), leftCuts[i]->leafNodes.end());
-                rootCut->leafNodes.insert(rootCut->leafNodes.end(), rightCuts[j]->leafNodes.begin(), rightCuts[j]->leafNodes.end());
-                rootCuts.push_back(rootCut);
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+const size_t CirCut::_varTruth[CIR_CUT_MAX_LEAVES] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+
+static inline unsigned countBits(size_t x) {
+    return __builtin_popcountll(x);
+}
+
+static inline bool lessLeaves(const CirCut& a, const CirCut& b) {
+    return a.getNumLeaves() < b.getNumLeaves();
+}
+
+// Swap the variables i < j of a truth table
+static inline size_t swapTruthVars(size_t t, unsigned i, unsigned j) {
+    const size_t mi = CirCut::varTruth(i), mj = CirCut::varTruth(j);
+    const size_t up = mi & ~mj, down = ~mi & mj;
+    const unsigned shift = (1U << j) - (1U << i);
+    return (t & ~(up | down)) | ((t & up) << shift) | ((t & down) >> shift);
+}
+
+/***********************************/
+/*   class CirCut member functions  */
+/***********************************/
+bool CirCut::dominates(const CirCut& c) const {
+    if (_nLeaves > c._nLeaves || (_sign & c._sign) != _sign) return false;
+    for (unsigned i = 0, j = 0; i < _nLeaves; ++i, ++j) {
+        while (j < c._nLeaves && c._leaves[j] < _leaves[i]) ++j;
+        if (j == c._nLeaves || c._leaves[j] != _leaves[i]) return false;
+    }
+    return true;
+}
+
+/**************************************/
+/*   class CirCutMan member functions  */
+/**************************************/
+CirCutMan::CirCutMan(unsigned maxLeaves, unsigned maxCuts)
+    : _maxLeaves(maxLeaves), _maxCuts(maxCuts) {
+    assert(maxLeaves >= 2 && maxLeaves <= CIR_CUT_MAX_LEAVES);
+    assert(maxCuts >= 1 && maxCuts < 255);
+}
+
+/**
+ * @brief Enumerates the priority cuts of the gates.
+ *
+ * @param dfsList The gates in topological order; the fanins of each AND
+ *                gate must come before it.
+ * @param numTots The size of the gate ID space.
+ */
+void CirCutMan::computeCuts(const GateList& dfsList, unsigned numTots) {
+    reset();
+    _cutStart.assign(numTots, 0);
+    _nCuts.assign(numTots, 0);
+    _arena.reserve(dfsList.size() * (_maxCuts / 2 + 1));
+    for (size_t i = 0, n = dfsList.size(); i < n; ++i)
+        gateGetCuts(dfsList[i]);
+}
+
+void CirCutMan::reset() {
+    vector<CirCut>().swap(_arena);
+    IdList().swap(_cutStart);
+    vector<unsigned char>().swap(_nCuts);
+    _cands.clear();
+}
+
+void CirCutMan::printCuts(unsigned gid) const {
+    for (unsigned i = 0, n = getNumCuts(gid); i < n; ++i) {
+        const CirCut& c = getCut(gid, i);
+        cout << "[" << i << "] {";
+        for (unsigned j = 0; j < c.getNumLeaves(); ++j)
+            cout << (j ? " " : "") << c.getLeaf(j);
+        cout << "} 0x" << hex << setfill('0') << setw(16) << c.getTruth()
+             << dec << setfill(' ') << endl;
+    }
+}
+
+// Cuts of one gate, appended to _arena: the kept merged cuts in the order
+// of size, then the trivial cut. Const 0 has one cut without leaves.
+void CirCutMan::gateGetCuts(const CirGate* g) {
+    const unsigned gid = g->getGid();
+    if (_nCuts[gid]) return;
+    _cands.clear();
+    if (g->isAig()) {
+        const CirGateV in0 = g->getIn0(), in1 = g->getIn1();
+        const CirGate *g0 = in0.gate(), *g1 = in1.gate();
+        if (!_nCuts[g0->getGid()]) gateGetCuts(g0);  // e.g. undefined
+        if (!_nCuts[g1->getGid()]) gateGetCuts(g1);
+        const unsigned s0 = _cutStart[g0->getGid()], n0 = _nCuts[g0->getGid()];
+        const unsigned s1 = _cutStart[g1->getGid()], n1 = _nCuts[g1->getGid()];
+        CirCut c;
+        for (unsigned i = 0; i < n0; ++i)
+            for (unsigned j = 0; j < n1; ++j) {
+                const CirCut &c0 = _arena[s0 + i], &c1 = _arena[s1 + j];
+                if (!mergeCuts(c0, c1, c)) continue;
+                size_t t0 = stretchTruth(c0._truth, c0, c);
+                size_t t1 = stretchTruth(c1._truth, c1, c);
+                c._truth  = (in0.isInv() ? ~t0 : t0) & (in1.isInv() ? ~t1 : t1);
+                addCandidate(c);
             }
+        stable_sort(_cands.begin(), _cands.end(), lessLeaves);
+        if (_cands.size() > _maxCuts) _cands.resize(_maxCuts);
+    }
+    _cutStart[gid] = _arena.size();
+    _arena.insert(_arena.end(), _cands.begin(), _cands.end());
+    CirCut c;
+    if (g->isConst()) {
+        c._nLeaves = 0;
+        c._sign = c._truth = 0;
+    } else setTrivialCut(c, gid);
+    _arena.push_back(c);
+    _nCuts[gid] = _cands.size() + 1;
+}
+
+void CirCutMan::setTrivialCut(CirCut& c, unsigned gid) const {
+    c._nLeaves   = 1;
+    c._leaves[0] = gid;
+    c._sign      = size_t(1) << (gid % 64);
+    c._truth     = CirCut::varTruth(0);
+}
+
+// Merge the sorted leaves; return false if there are more than _maxLeaves
+bool CirCutMan::mergeCuts(const CirCut& c0, const CirCut& c1, CirCut& c) const {
+    c._sign = c0._sign | c1._sign;
+    if (countBits(c._sign) > _maxLeaves) return false;
+    unsigned i = 0, j = 0, k = 0;
+    while (i < c0._nLeaves || j < c1._nLeaves) {
+        if (k == _maxLeaves) return false;
+        if (j == c1._nLeaves || (i < c0._nLeaves && c0._leaves[i] < c1._leaves[j]))
+            c._leaves[k++] = c0._leaves[i++];
+        else if (i == c0._nLeaves || c1._leaves[j] < c0._leaves[i])
+            c._leaves[k++] = c1._leaves[j++];
+        else {
+            c._leaves[k++] = c0._leaves[i++];
+            ++j;
+        }
+    }
+    c._nLeaves = k;
+    return true;
+}
+
+// return false if c is dominated by a candidate; otherwise, the candidates
+// dominated by c are removed and c is added
+bool CirCutMan::addCandidate(const CirCut& c) {
+    for (size_t i = 0, n = _cands.size(); i < n; ++i)
+        if (_cands[i].dominates(c)) return false;
+    size_t k = 0;
+    for (size_t i = 0, n = _cands.size(); i < n; ++i)
+        if (!c.dominates(_cands[i])) _cands[k++] = _cands[i];
+    _cands.resize(k);
+    _cands.push_back(c);
+    return true;
+}
+
+// Re-express the truth table t over the leaves of sub in terms of the
+// leaves of sup (a superset of sub)
+size_t CirCutMan::stretchTruth(size_t t, const CirCut& sub, const CirCut& sup) {
+    unsigned pos[CIR_CUT_MAX_LEAVES];
+    for (unsigned i = 0, j = 0; i < sub._nLeaves; ++i, ++j) {
+        while (sup._leaves[j] != sub._leaves[i]) ++j;
+        pos[i] = j;
+    }
+    // From the last variable, so the target position is always unused
+    for (unsigned i = sub._nLeaves; i-- > 0;)
+        if (pos[i] != i) t = swapTruthVars(t, i, pos[i]);
+    return t;
+}
+
+/**************************************/
+/*   class CirCutSim member functions  */
+/**************************************/
+/**
+ * @brief Computes the complete truth table of a node over a cut.
+ *
+ * The cached table is returned if (root, leaves) was simulated before.
+ * Otherwise the cone is collected in topological order and simulated
+ * word by word: the leaves take the elementary tables, const 0 is all 0,
+ * and each AND gate is the AND of its (complemented) fanin tables.
+ *
+ * @param root    The node; it may be one of the leaves.
+ * @param leaves  Gate IDs of the leaves; leaf i is variable i.
+ * @param nLeaves At most CIR_CUTSIM_MAX_LEAVES.
+ * @return The table in getNumWords(nLeaves) words, or 0 if the cone of
+ *         root reaches a PI, RO or undefined gate that is not a leaf.
+ */
+const size_t* CirCutSim::simulate(const CirGate* root, const unsigned* leaves,
+                                  unsigned nLeaves) {
+    assert(nLeaves <= CIR_CUTSIM_MAX_LEAVES);
+    const size_t nWords = getNumWords(nLeaves);
+    const size_t key    = hashKey(root->getGid(), leaves, nLeaves);
+    unordered_map<size_t, IdList>::const_iterator it = _cache.find(key);
+    if (it != _cache.end())
+        for (size_t k = 0, n = it->second.size(); k < n; ++k) {
+            const Entry& e = _entries[it->second[k]];
+            if (e.root != root->getGid() || e.nLeaves != nLeaves ||
+                !equal(leaves, leaves + nLeaves, _leafArena.begin() + e.leafStart))
+                continue;
+            ++_nHits;
+            return &_tableArena[e.tableStart];
+        }
+    if (!collectCone(root, leaves, nLeaves)) return 0;
+    ++_nSims;
+
+    // slot i < nLeaves: leaf i; slot nLeaves + k: _cone[k]
+    _work.resize((nLeaves + _cone.size()) * nWords);
+    for (unsigned i = 0; i < nLeaves; ++i) {
+        size_t* t = &_work[i * nWords];
+        for (size_t w = 0; w < nWords; ++w)
+            t[w] = (i < 6) ? CirCut::varTruth(i)
+                           : (((w >> (i - 6)) & 1) ? ~size_t(0) : 0);
+    }
+    for (size_t k = 0, n = _cone.size(); k < n; ++k) {
+        const CirGate* g = _cone[k];
+        size_t* t        = &_work[(nLeaves + k) * nWords];
+        if (g->isConst()) {
+            fill(t, t + nWords, size_t(0));
+            continue;
+        }
+        const CirGateV in0 = g->getIn0(), in1 = g->getIn1();
+        const size_t* t0   = &_work[_slot[in0.gate()->getGid()] * nWords];
+        const size_t* t1   = &_work[_slot[in1.gate()->getGid()] * nWords];
+        const size_t m0 = in0.isInv() ? ~size_t(0) : 0;
+        const size_t m1 = in1.isInv() ? ~size_t(0) : 0;
+        for (size_t w = 0; w < nWords; ++w) t[w] = (t0[w] ^ m0) & (t1[w] ^ m1);
+    }
+
+    if (_tableArena.size() + nWords > CIR_CUTSIM_CACHE_WORDS) reset();
+    Entry e;
+    e.root       = root->getGid();
+    e.nLeaves    = nLeaves;
+    e.leafStart  = _leafArena.size();
+    e.tableStart = _tableArena.size();
+    _leafArena.insert(_leafArena.end(), leaves, leaves + nLeaves);
+    const size_t* t = &_work[_slot[root->getGid()] * nWords];
+    _tableArena.insert(_tableArena.end(), t, t + nWords);
+    _cache[key].push_back(_entries.size());
+    _entries.push_back(e);
+    return &_tableArena[e.tableStart];
+}
+
+void CirCutSim::reset() {
+    _cache.clear();
+    _entries.clear();
+    _leafArena.clear();
+    _tableArena.clear();
+}
+
+size_t CirCutSim::hashKey(unsigned root, const unsigned* leaves, unsigned n) {
+    size_t h = (size_t(root) + 1) * 0x9e3779b97f4a7c15ULL;
+    for (unsigned i = 0; i < n; ++i) h = (h ^ leaves[i]) * 0x100000001b3ULL;
+    return h ^ n;
+}
+
+// _cone = the gates between root and the leaves in topological order, with
+// _slot set for them and the leaves; return false if a PI, RO or undefined
+// gate out of the leaves is reached
+bool CirCutSim::collectCone(const CirGate* root, const unsigned* leaves,
+                            unsigned n) {
+    if (++_stamp == 0) {  // wrapped around
+        fill(_mark.begin(), _mark.end(), 0);
+        _stamp = 1;
+    }
+    for (unsigned i = 0; i < n; ++i) {
+        if (leaves[i] >= _mark.size()) {
+            _mark.resize(leaves[i] + 1, 0);
+            _slot.resize(leaves[i] + 1);
+        }
+        _mark[leaves[i]] = _stamp;
+        _slot[leaves[i]] = i;
+    }
+    _cone.clear();
+    _stack.clear();
+    _stack.push_back(make_pair(root, false));
+    while (!_stack.empty()) {
+        const CirGate* g = _stack.back().first;
+        const bool done  = _stack.back().second;
+        const unsigned gid = g->getGid();
+        _stack.pop_back();
+        if (done) {  // all the fanins are in the cone
+            _slot[gid] = n + _cone.size();
+            _cone.push_back(const_cast<CirGate*>(g));
+            continue;
         }
+        if (gid >= _mark.size()) {
+            _mark.resize(gid + 1, 0);
+            _slot.resize(gid + 1);
+        }
+        if (_mark[gid] == _stamp) continue;
+        _mark[gid] = _stamp;
+        if (g->isConst()) {
+            _slot[gid] = n + _cone.size();
+            _cone.push_back(const_cast<CirGate*>(g));
+            continue;
+        }
+        if (!g->isAig()) return false;
+        _stack.push_back(make_pair(g, true));
+        _stack.push_back(make_pair(g->getIn1Gate(), false));
+        _stack.push_back(make_pair(g->getIn0Gate(), false));
     }
-    gate2Cut[root] = rootCuts;
-    // for(const auto& cut : rootCuts) {
-    //     cout << "root " << root->getName() << " cut size " << cut->leafNodes.size() << endl;
-    //     for(const auto& gate : cut->leafNodes) {
-    //         cout << gate->getName() << " ";
-    //     }
-    //     cout << endl;
-    // }
-    return rootCuts;
-}
-#endif
+    return true;
+}
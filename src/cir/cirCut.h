@@ -1,22 +1,208 @@
+/****************************************************************************
+  FileName     [ cirCut.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the priority-cut manager and the rewriting library ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
 #ifndef CIR_CUT_H
 #define CIR_CUT_H
+
 #include <unordered_map>
-#include "cirMgr.h"
-#include "cirGate.h"
+#include <vector>
+
+#include "cirDef.h"
+
+using namespace std;
 
+// Truth tables are one 64-bit word ==> at most 6 leaves
+#define CIR_CUT_MAX_LEAVES 6
+// Default # of cuts kept per node (the trivial cut excluded)
+#define CIR_CUT_MAX_CUTS 8
+// Exhaustive cut simulation: 2^16 patterns ==> 1024 words per table
+#define CIR_CUTSIM_MAX_LEAVES 16
+// # of cached table words before the cache of CirCutSim is flushed
+#define CIR_CUTSIM_CACHE_WORDS (size_t(1) << 22)
+
+//------------------------------------------------------------------------
+//   class CirCut
+//------------------------------------------------------------------------
+// A cut of a node: the leaves are gate IDs in ascending order, and _truth
+// is the function of the node over the leaves (leaf i is variable i). The
+// table is always 64 bits, i.e. it does not depend on the variables
+// beyond _nLeaves.
+//
 class CirCut {
-    public:
-    int cutSize;
-    GateList leafNodes;
+public:
+    unsigned getNumLeaves() const { return _nLeaves; }
+    unsigned getLeaf(unsigned i) const { return _leaves[i]; }
+    const unsigned* getLeaves() const { return _leaves; }
+    size_t getSign() const { return _sign; }
+    size_t getTruth() const { return _truth; }
+
+    // true if the leaves of this cut are a subset of those of c
+    bool dominates(const CirCut& c) const;
+
+    // Truth tables of the elementary variables
+    static size_t varTruth(unsigned i) { return _varTruth[i]; }
+
+private:
+    friend class CirCutMan;
+
+    unsigned _nLeaves;
+    unsigned _leaves[CIR_CUT_MAX_LEAVES];
+    size_t _sign;   // bit (gid % 64) is set for each leaf
+    size_t _truth;
+
+    static const size_t _varTruth[CIR_CUT_MAX_LEAVES];
 };
 
+//------------------------------------------------------------------------
+//   class CirCutMan
+//------------------------------------------------------------------------
+// Priority cuts: each node keeps at most _maxCuts cuts of at most _maxLeaves
+// leaves, merged from those of its fanins. A merged cut is dropped if a
+// kept cut dominates it, and kept cuts dominated by it are dropped; the
+// smallest cuts are kept. Every node also has its trivial cut (itself),
+// stored last. All the cuts are in one arena and a node refers to them by
+// offset, so there is no per-cut allocation.
+//
 class CirCutMan {
-    public:
-    vector<CirCut*> gateGetCuts(CirGate* root, int k);
-    unordered_map<CirGate*, vector<CirCut*>> gate2Cut;
+public:
+    CirCutMan(unsigned maxLeaves = 4, unsigned maxCuts = CIR_CUT_MAX_CUTS);
+    ~CirCutMan() {}
+
+    // Enumerate the cuts of all the gates in dfsList (topologically sorted)
+    void computeCuts(const GateList& dfsList, unsigned numTots);
+    void reset();
+
+    // Cuts of a gate; empty if the gate is not enumerated
+    unsigned getNumCuts(unsigned gid) const {
+        return (gid < _nCuts.size()) ? _nCuts[gid] : 0;
+    }
+    const CirCut& getCut(unsigned gid, unsigned i) const {
+        return _arena[_cutStart[gid] + i];
+    }
+    unsigned getMaxLeaves() const { return _maxLeaves; }
+    unsigned getMaxCuts() const { return _maxCuts; }
+    size_t getNumTotCuts() const { return _arena.size(); }
+
+    void printCuts(unsigned gid) const;
+
+private:
+    unsigned _maxLeaves;
+    unsigned _maxCuts;
+    vector<CirCut> _arena;
+    IdList _cutStart;              // gate ID -> offset in _arena
+    vector<unsigned char> _nCuts;  // gate ID -> # of cuts
+    vector<CirCut> _cands;         // scratch of gateGetCuts()
 
+    void gateGetCuts(const CirGate* g);
+    void setTrivialCut(CirCut& c, unsigned gid) const;
+    bool mergeCuts(const CirCut& c0, const CirCut& c1, CirCut& c) const;
+    bool addCandidate(const CirCut& c);
+    static size_t stretchTruth(size_t t, const CirCut& sub, const CirCut& sup);
 };
 
+//------------------------------------------------------------------------
+//   class CirCutSim
+//------------------------------------------------------------------------
+// Complete truth tables of a node over a cut of up to 16 leaves, in
+// getNumWords(nLeaves) words: leaf i is variable i, which is the pattern
+// of CirCut::varTruth(i) within a word for i < 6, and bit (i - 6) of the
+// word index for i >= 6. The cone between the node and the leaves is
+// simulated once on all the 2^nLeaves patterns. The tables are cached per
+// (node, leaves), so they must be reset() when the netlist is edited.
+//
+class CirCutSim {
+public:
+    CirCutSim() : _stamp(0), _nHits(0), _nSims(0) {}
+    ~CirCutSim() {}
 
+    // The table of root over the leaves (any order, no duplicates), valid
+    // until the next call; 0 if the leaves do not cut the cone of root
+    const size_t* simulate(const CirGate* root, const unsigned* leaves,
+                           unsigned nLeaves);
+    void reset();
+
+    static unsigned getNumWords(unsigned nLeaves) {
+        return (nLeaves <= 6) ? 1 : (1U << (nLeaves - 6));
+    }
+    size_t getNumHits() const { return _nHits; }
+    size_t getNumSims() const { return _nSims; }
+
+private:
+    // Cache entry: root, leaves at _leafArena[leafStart, + nLeaves), table
+    // at _tableArena[tableStart, + getNumWords(nLeaves))
+    struct Entry {
+        unsigned root;
+        unsigned nLeaves;
+        size_t leafStart;
+        size_t tableStart;
+    };
+
+    unordered_map<size_t, IdList> _cache;  // key hash -> entries
+    vector<Entry> _entries;
+    IdList _leafArena;
+    vector<size_t> _tableArena;
+    // scratch of the cone simulation, indexed by gate ID
+    IdList _mark;   // == _stamp if visited in the current call
+    IdList _slot;   // word offset in _work
+    unsigned _stamp;
+    vector<size_t> _work;
+    vector<pair<const CirGate*, bool> > _stack;
+    GateList _cone;
+    size_t _nHits;
+    size_t _nSims;
+
+    static size_t hashKey(unsigned root, const unsigned* leaves, unsigned n);
+    bool collectCone(const CirGate* root, const unsigned* leaves, unsigned n);
+};
+
+//------------------------------------------------------------------------
+//   class CirRwrLib
+//------------------------------------------------------------------------
+// AIG structures of the 4-input functions (16-bit truth tables), one per
+// NPN class. A structure is a list of AND nodes over the literals
+//    0/1 : const 0/1,   2(i+1)[+1] : input i,   2(5+k)[+1] : node k
+// A function t is realized by the structure of its class with input i
+// driven by leaf getInput(t, i) (complemented if isInputInv(t, i)) and
+// the output complemented if isOutputInv(t).
+//
+struct CirRwrStruct {
+    vector<pair<unsigned char, unsigned char> > _nodes;
+    unsigned char _out;
+};
+
+class CirRwrLib {
+public:
+    CirRwrLib();
+    ~CirRwrLib() {}
+
+    unsigned getNumClasses() const { return _structs.size(); }
+    const CirRwrStruct& getStruct(unsigned t) const {
+        return _structs[_classOf[t]];
+    }
+    unsigned getInput(unsigned t, unsigned i) const {
+        return _perms[_trans[t] >> 5][i];
+    }
+    bool isInputInv(unsigned t, unsigned i) const { return (_trans[t] >> i) & 1; }
+    bool isOutputInv(unsigned t) const { return (_trans[t] >> 4) & 1; }
+
+private:
+    vector<unsigned short> _classOf;  // truth table -> class
+    vector<unsigned short> _trans;    // (perm << 5) | (outInv << 4) | inInvs
+    vector<CirRwrStruct> _structs;    // of each class
+    vector<unsigned char> _cost;      // scratch of the synthesis
+    vector<unsigned short> _choice;
+
+    static const unsigned char _perms[24][4];
+
+    static unsigned transform(unsigned t, unsigned perm, unsigned phase);
+    unsigned getCost(unsigned t);
+    unsigned synthesize(unsigned t, CirRwrStruct& s);
+    unsigned addNode(CirRwrStruct& s, unsigned a, unsigned b) const;
+};
 
-#endif
\ No newline at end of file
+#endif  // CIR_CUT_H
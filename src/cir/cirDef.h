@@ -18,6 +18,13 @@ using namespace std;
 
 // TODO: define your own typedef or enum
 
+// Number of 64-bit words simulated per gate in one pass over the netlist.
+// Override with -DCIR_SIM_WORDS=<n> (8 for AVX-512, 4 for AVX2).
+#ifndef CIR_SIM_WORDS
+#define CIR_SIM_WORDS 4
+#endif
+#define CIR_SIM_PATTERNS (CIR_SIM_WORDS * 64)
+
 class CirPValue;
 class CirGateV;
 class CirGate;
@@ -30,6 +37,7 @@ class CirMgr;
 class SatSolver;
 class CirCut;
 class CirCutMan;
+class CirStrashKey;
 
 typedef vector<CirGate*> GateList;
 typedef vector<CirGateV> GateVList;
@@ -44,9 +52,12 @@ typedef vector<CirRiGate*> RiArray;
 typedef vector<CirRoGate*> RoArray;
 typedef vector<CirPiGate*> PiArray;
 typedef vector<CirPoGate*> PoArray;
-typedef HashMap<CirPValue, IdList*> FECHash;
+typedef HashMap<CirStrashKey, CirGate*> StrashHash;
 typedef vector<CirAigGate*> AigArray;
 typedef unordered_map<unsigned, unsigned> IDMap;
+typedef unordered_map<unsigned, char*> NameMap;
+// A SimPattern holds CIR_SIM_WORDS words per PI:
+//    pattern[i * CIR_SIM_WORDS + w] ==> word w of PI i
 typedef size_t* SimPattern;
 typedef vector<SimPattern> SimVector;
 
@@ -62,4 +73,22 @@ enum GateType {
     TOT_GATE
 };
 
+// Key of the structural hash table: the two fanin literals (CirGateV
+// values) of an AND gate, sorted so that (a & b) and (b & a) collide
+class CirStrashKey {
+public:
+    CirStrashKey(size_t in0 = 0, size_t in1 = 0)
+        : _in0(in0 < in1 ? in0 : in1), _in1(in0 < in1 ? in1 : in0) {}
+
+    size_t operator()() const { return ((_in0 << 3) ^ (_in1 >> 1)); }
+
+    bool operator==(const CirStrashKey& k) const {
+        return (_in0 == k._in0) && (_in1 == k._in1);
+    }
+
+private:
+    size_t _in0;
+    size_t _in1;
+};
+
 #endif  // CIR_DEF_H
@@ -0,0 +1,399 @@
+/****************************************************************************
+  FileName     [ cirFlat.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the flat (struct-of-arrays) AIG functions ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include "cirFlat.h"
+
+#include <cassert>
+
+#include "SolverV.h"
+#include "cirGate.h"
+#include "cirMgr.h"
+
+using namespace std;
+
+// A level is split among the threads only if each gets at least this many
+// AND gates; the smaller levels are done by the calling thread alone
+#define CIR_LEVEL_SIM_GRAIN 256
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// Reusable barrier of the level-parallel simulation
+class CirSimBarrier {
+public:
+    CirSimBarrier(unsigned n) : _n(n), _count(0), _phase(0) {}
+    void wait() {
+        unique_lock<mutex> lock(_mutex);
+        const unsigned phase = _phase;
+        if (++_count == _n) {
+            _count = 0;
+            ++_phase;
+            _cond.notify_all();
+        } else
+            _cond.wait(lock, [this, phase] { return _phase != phase; });
+    }
+
+private:
+    mutex _mutex;
+    condition_variable _cond;
+    unsigned _n, _count, _phase;
+};
+
+/**
+ * @brief Builds the flat AIG from the DFS list of a circuit.
+ *
+ * Only the AND gates in the DFS list (i.e. in the fanin cones of the POs
+ * and RIs) are copied. Undefined gates are treated as const 0.
+ *
+ * @param cirMgr The circuit to be copied; it must be levelized.
+ */
+void CirFlatAig::build(const CirMgr* cirMgr) {
+    assert(cirMgr->isLevelized());
+    reset();
+    _numPIs    = cirMgr->getNumPIs();
+    _numLATCHs = cirMgr->getNumLATCHs();
+
+    const GateList& dfsList = cirMgr->getDfsList();
+    size_t nObjs            = getAndBegin();
+    for (size_t i = 0, n = dfsList.size(); i < n; ++i)
+        if (dfsList[i]->isAig()) ++nObjs;
+    _gids.reserve(nObjs);
+    _fanin0.reserve(nObjs);
+    _fanin1.reserve(nObjs);
+    _gid2Idx.assign(cirMgr->getNumTots(), UINT_MAX);
+
+    _gids.push_back(CirMgr::_const0->getGid());
+    for (unsigned i = 0; i < _numPIs; ++i)
+        _gids.push_back(cirMgr->getPi(i)->getGid());
+    for (unsigned i = 0; i < _numLATCHs; ++i)
+        _gids.push_back(cirMgr->getRo(i)->getGid());
+    _fanin0.resize(_gids.size(), 0);
+    _fanin1.resize(_gids.size(), 0);
+    for (unsigned i = 0, n = _gids.size(); i < n; ++i)
+        _gid2Idx[_gids[i]] = i;
+
+    // Level by level ==> fanins are always mapped first
+    _levelStart.assign(cirMgr->getNumLevels(), 0);
+    for (unsigned l = 1, nl = cirMgr->getNumLevels(); l < nl; ++l) {
+        _levelStart[l] = _gids.size();
+        for (unsigned j = 0, m = cirMgr->getLevelSize(l); j < m; ++j) {
+            const CirGate* g = cirMgr->getLevelGate(l, j);
+            _gid2Idx[g->getGid()] = _gids.size();
+            _gids.push_back(g->getGid());
+            _fanin0.push_back(toFlatLit(g->getIn0()));
+            _fanin1.push_back(toFlatLit(g->getIn1()));
+        }
+    }
+    assert(_gids.size() == nObjs);
+
+    _poLits.resize(cirMgr->getNumPOs());
+    for (unsigned i = 0, n = _poLits.size(); i < n; ++i)
+        _poLits[i] = toFlatLit(cirMgr->getPo(i)->getIn0());
+    _riLits.resize(_numLATCHs);
+    for (unsigned i = 0; i < _numLATCHs; ++i)
+        _riLits[i] = toFlatLit(cirMgr->getRi(i)->getIn0());
+}
+
+void CirFlatAig::reset() {
+    _numPIs = _numLATCHs = 0;
+    _gids.clear();
+    _gid2Idx.clear();
+    _fanin0.clear();
+    _fanin1.clear();
+    _poLits.clear();
+    _riLits.clear();
+    _levelStart.clear();
+}
+
+FlatLit CirFlatAig::toFlatLit(const CirGateV& v) const {
+    const CirGate* g = v.gate();
+    unsigned idx     = (g == 0) ? UINT_MAX : getIdx(g->getGid());
+    if (idx == UINT_MAX) idx = 0;  // undefined ==> const 0
+    return (idx << 1) | (v.isInv() ? 1 : 0);
+}
+
+/**
+ * @brief Simulates (64 * nWords) patterns through the AND gates.
+ *
+ * @param values The value rows of all the objects (see cirFlat.h).
+ * @param nWords The number of words per row.
+ */
+void CirFlatAig::simulate(vector<size_t>& values, size_t nWords,
+                          unsigned nThreads) const {
+    if (nThreads > 1 && getNumAnds() >= nThreads * CIR_LEVEL_SIM_GRAIN) {
+        CirSimPool pool(*this, nThreads);
+        pool.simulate(values, nWords);
+        return;
+    }
+    assert(values.size() >= getNumObjs() * nWords);
+    size_t* val = &values[0];
+    for (size_t w = 0; w < nWords; ++w) val[w] = 0;
+    simulateAnds(val, nWords, getAndBegin(), getNumObjs());
+}
+
+void CirFlatAig::simulateAnds(size_t* val, size_t nWords, unsigned begin,
+                              unsigned end) const {
+    for (unsigned i = begin; i < end; ++i) {
+        const FlatLit a = _fanin0[i], b = _fanin1[i];
+        const size_t* va = val + litIdx(a) * nWords;
+        const size_t* vb = val + litIdx(b) * nWords;
+        const size_t ma = litInv(a) ? ~size_t(0) : 0;
+        const size_t mb = litInv(b) ? ~size_t(0) : 0;
+        size_t* vo      = val + size_t(i) * nWords;
+        for (size_t w = 0; w < nWords; ++w)
+            vo[w] = (va[w] ^ ma) & (vb[w] ^ mb);
+    }
+}
+
+// AND of ternary values: may be 1 only if both may be 1; may be 0 if
+// either may be 0
+void CirFlatAig::simulateTernary(vector<size_t>& values, size_t nWords) const {
+    assert(values.size() >= size_t(getNumObjs()) * 2 * nWords);
+    size_t* val = &values[0];
+    for (size_t w = 0; w < nWords; ++w) {
+        val[w]          = ~size_t(0);
+        val[nWords + w] = 0;
+    }
+    for (unsigned i = getAndBegin(), n = getNumObjs(); i < n; ++i) {
+        const FlatLit a = _fanin0[i], b = _fanin1[i];
+        const size_t* a0 = val + (litIdx(a) * 2 + litInv(a)) * nWords;
+        const size_t* a1 = val + (litIdx(a) * 2 + !litInv(a)) * nWords;
+        const size_t* b0 = val + (litIdx(b) * 2 + litInv(b)) * nWords;
+        const size_t* b1 = val + (litIdx(b) * 2 + !litInv(b)) * nWords;
+        size_t* o0       = val + size_t(i) * 2 * nWords;
+        size_t* o1       = o0 + nWords;
+        for (size_t w = 0; w < nWords; ++w) {
+            o0[w] = a0[w] | b0[w];
+            o1[w] = a1[w] & b1[w];
+        }
+    }
+}
+
+/**
+ * @brief Adds the CNF of one time frame of the AIG to a solver.
+ *
+ * @param solver The SAT solver.
+ * @param vars   Returns the SAT variable of each object.
+ */
+void CirFlatAig::addToSolver(SolverV& solver, vector<int>& vars) const {
+    vars.resize(getNumObjs());
+    vars[0] = solver.newVar();
+    solver.addUnit(mkLit(vars[0], true));
+    for (unsigned i = 1, n = getAndBegin(); i < n; ++i)
+        vars[i] = solver.newVar();
+    for (unsigned i = getAndBegin(), n = getNumObjs(); i < n; ++i) {
+        vars[i] = solver.newVar();
+        Lit y   = mkLit(vars[i]);
+        Lit a   = mkLit(vars[litIdx(_fanin0[i])], litInv(_fanin0[i]));
+        Lit b   = mkLit(vars[litIdx(_fanin1[i])], litInv(_fanin1[i]));
+        // y = a & b
+        solver.addBinary(a, ~y);
+        solver.addBinary(b, ~y);
+        solver.addTernary(~a, ~b, y);
+    }
+}
+
+/**
+ * @brief Groups the levels of the flat AIG into phases and starts the
+ *        worker threads.
+ *
+ * @param aig      The flat AIG; it must not change while the pool is alive.
+ * @param nThreads The number of threads, the calling one included.
+ */
+CirSimPool::CirSimPool(const CirFlatAig& aig, unsigned nThreads)
+    : _aig(aig), _nThreads(nThreads ? nThreads : 1), _barrier(0), _job(0),
+      _stop(false), _val(0), _nWords(0) {
+    if (_nThreads == 1) return;
+    _phaseStart.push_back(aig.getAndBegin());
+    for (unsigned l = 1, nl = aig.getNumLevels(); l < nl; ++l) {
+        const unsigned b = aig.getLevelBegin(l), e = aig.getLevelBegin(l + 1);
+        const bool split = e - b >= _nThreads * CIR_LEVEL_SIM_GRAIN;
+        if (!split && !_split.empty() && !_split.back())
+            _phaseStart.back() = e;  // one more small level to the caller
+        else {
+            _phaseStart.push_back(e);
+            _split.push_back(split);
+        }
+    }
+    bool parallel = false;
+    for (size_t k = 0, n = _split.size(); k < n; ++k)
+        if (_split[k]) parallel = true;
+    if (!parallel) {
+        _nThreads = 1;
+        return;
+    }
+    _barrier = new CirSimBarrier(_nThreads);
+    for (unsigned t = 1; t < _nThreads; ++t)
+        _workers.push_back(thread(&CirSimPool::work, this, t));
+}
+
+CirSimPool::~CirSimPool() {
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cond.notify_all();
+    for (size_t t = 0, n = _workers.size(); t < n; ++t) _workers[t].join();
+    delete _barrier;
+}
+
+void CirSimPool::simulate(vector<size_t>& values, size_t nWords) {
+    assert(values.size() >= _aig.getNumObjs() * nWords);
+    size_t* val = &values[0];
+    for (size_t w = 0; w < nWords; ++w) val[w] = 0;
+    if (_nThreads == 1) {
+        _aig.simulateAnds(val, nWords, _aig.getAndBegin(), _aig.getNumObjs());
+        return;
+    }
+    {
+        lock_guard<mutex> lock(_mutex);
+        _val    = val;
+        _nWords = nWords;
+        ++_job;
+    }
+    _cond.notify_all();
+    simulatePhases(0);
+}
+
+// Worker t: wait for each new job and do its share of it
+void CirSimPool::work(unsigned t) {
+    size_t done = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(_mutex);
+            _cond.wait(lock, [this, done] { return _stop || _job != done; });
+            if (_stop) return;
+            done = _job;
+        }
+        simulatePhases(t);
+    }
+}
+
+// Thread t: its share of each phase, then wait for the others. A last
+// phase done by the caller needs no barrier: the workers have nothing
+// left to do in this job.
+void CirSimPool::simulatePhases(unsigned t) const {
+    for (size_t k = 0, n = _split.size(); k < n; ++k) {
+        const unsigned b = _phaseStart[k], e = _phaseStart[k + 1];
+        if (_split[k])
+            _aig.simulateAnds(_val, _nWords, b + size_t(e - b) * t / _nThreads,
+                              b + size_t(e - b) * (t + 1) / _nThreads);
+        else if (t == 0)
+            _aig.simulateAnds(_val, _nWords, b, e);
+        if (k + 1 < n || _split[k]) _barrier->wait();
+    }
+}
+
+/**
+ * @brief Builds the levels and the fanout lists of the flat AIG.
+ *
+ * @param aig    The flat AIG; it must not change during the simulation.
+ * @param nWords The number of words simulated per object.
+ */
+CirEventSim::CirEventSim(const CirFlatAig& aig, size_t nWords)
+    : _aig(aig), _nWords(nWords), _initialized(false), _newRound(false),
+      _numEvals(0), _numRounds(0) {
+    const unsigned nObjs = aig.getNumObjs();
+    _values.assign(size_t(nObjs) * nWords, 0);
+    _levels.assign(nObjs, 0);
+    _foStart.assign(nObjs + 1, 0);
+    unsigned maxLevel = 0;
+    for (unsigned i = aig.getAndBegin(); i < nObjs; ++i) {
+        unsigned a = CirFlatAig::litIdx(aig.getFanin0(i));
+        unsigned b = CirFlatAig::litIdx(aig.getFanin1(i));
+        _levels[i] = 1 + (_levels[a] > _levels[b] ? _levels[a] : _levels[b]);
+        if (_levels[i] > maxLevel) maxLevel = _levels[i];
+        ++_foStart[a + 1];
+        if (b != a) ++_foStart[b + 1];
+    }
+    for (unsigned i = 0; i < nObjs; ++i) _foStart[i + 1] += _foStart[i];
+    _fanouts.resize(_foStart[nObjs]);
+    IdList fill(_foStart.begin(), _foStart.end() - 1);
+    for (unsigned i = aig.getAndBegin(); i < nObjs; ++i) {
+        unsigned a = CirFlatAig::litIdx(aig.getFanin0(i));
+        unsigned b = CirFlatAig::litIdx(aig.getFanin1(i));
+        _fanouts[fill[a]++] = i;
+        if (b != a) _fanouts[fill[b]++] = i;
+    }
+    _buckets.resize(maxLevel + 1);
+    _queued.assign(nObjs, false);
+}
+
+void CirEventSim::schedule(unsigned idx) {
+    for (unsigned j = _foStart[idx], n = _foStart[idx + 1]; j < n; ++j) {
+        unsigned fo = _fanouts[j];
+        if (_queued[fo]) continue;
+        _queued[fo] = true;
+        _buckets[_levels[fo]].push_back(fo);
+    }
+}
+
+void CirEventSim::setInput(unsigned idx, const size_t* words) {
+    assert(idx > 0 && !_aig.isAnd(idx));
+    startRound();
+    size_t* v    = &_values[size_t(idx) * _nWords];
+    bool changed = false;
+    for (size_t w = 0; w < _nWords; ++w)
+        if (v[w] != words[w]) {
+            v[w]    = words[w];
+            changed = true;
+        }
+    if (changed && _initialized) {
+        _changed.push_back(idx);
+        schedule(idx);
+    }
+}
+
+size_t CirEventSim::propagate() {
+    startRound();
+    _newRound = true;
+    ++_numRounds;
+    if (!_initialized) {
+        // first round: evaluate everything
+        _initialized = true;
+        _aig.simulate(_values, _nWords);
+        _changed.resize(_aig.getNumObjs() - 1);
+        for (unsigned i = 1, n = _aig.getNumObjs(); i < n; ++i)
+            _changed[i - 1] = i;
+        _numEvals += _aig.getNumAnds();
+        return _aig.getNumAnds();
+    }
+
+    size_t nEvals = 0;
+    size_t* val   = &_values[0];
+    for (size_t l = 1, nl = _buckets.size(); l < nl; ++l) {
+        IdList& bucket = _buckets[l];
+        // fanouts are always on higher levels ==> bucket does not grow here
+        for (size_t k = 0, nk = bucket.size(); k < nk; ++k) {
+            const unsigned i = bucket[k];
+            _queued[i]       = false;
+            ++nEvals;
+            const FlatLit a = _aig.getFanin0(i), b = _aig.getFanin1(i);
+            const size_t* va = val + size_t(CirFlatAig::litIdx(a)) * _nWords;
+            const size_t* vb = val + size_t(CirFlatAig::litIdx(b)) * _nWords;
+            const size_t ma  = CirFlatAig::litInv(a) ? ~size_t(0) : 0;
+            const size_t mb  = CirFlatAig::litInv(b) ? ~size_t(0) : 0;
+            size_t* vo       = val + size_t(i) * _nWords;
+            bool changed     = false;
+            for (size_t w = 0; w < _nWords; ++w) {
+                size_t v = (va[w] ^ ma) & (vb[w] ^ mb);
+                if (v != vo[w]) {
+                    vo[w]   = v;
+                    changed = true;
+                }
+            }
+            if (changed) {
+                _changed.push_back(i);
+                schedule(i);
+            }
+        }
+        bucket.clear();
+    }
+    _numEvals += nEvals;
+    return nEvals;
+}
@@ -0,0 +1,228 @@
+/****************************************************************************
+  FileName     [ cirFlat.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the flat (struct-of-arrays) AIG ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_FLAT_H
+#define CIR_FLAT_H
+
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cirDef.h"
+
+using namespace std;
+
+class SolverV;
+class CirSimBarrier;
+
+// Literal of the flat AIG: (index << 1) | complement
+// Index 0 is const 0 ==> literal 0 is const 0 and literal 1 is const 1
+typedef unsigned FlatLit;
+
+//------------------------------------------------------------------------
+//   class CirFlatAig
+//------------------------------------------------------------------------
+// A compact copy of the AIG in CirMgr, with all the objects in one index
+// space:
+//    0                       : const 0
+//    [1, 1 + #PI)            : PIs, in the order of CirMgr::getPi()
+//    [.., .. + #LATCH)       : latch outputs (RO), in the order of getRo()
+//    [.., getNumObjs())      : AND gates in level order (see below)
+// POs and latch inputs (RI) are not objects; only their fanin literals are
+// kept. The AND gates are sorted by CirMgr::getLevel() (DFS order within a
+// level), so the gates of one level are contiguous and independent of
+// each other, and the SAT variables of addToSolver() follow the levels.
+// All the per-object data are in flat arrays indexed by the object index,
+// so a sweep over the AND gates touches contiguous memory only.
+//
+class CirFlatAig {
+public:
+    CirFlatAig() : _numPIs(0), _numLATCHs(0) {}
+    ~CirFlatAig() {}
+
+    void build(const CirMgr* cirMgr);
+    void reset();
+
+    // Access functions
+    unsigned getNumObjs() const { return _gids.size(); }
+    unsigned getNumPIs() const { return _numPIs; }
+    unsigned getNumLATCHs() const { return _numLATCHs; }
+    unsigned getNumPOs() const { return _poLits.size(); }
+    unsigned getNumAnds() const { return getNumObjs() - getAndBegin(); }
+    unsigned getPiIdx(unsigned i) const { return 1 + i; }
+    unsigned getRoIdx(unsigned i) const { return 1 + _numPIs + i; }
+    unsigned getAndBegin() const { return 1 + _numPIs + _numLATCHs; }
+    bool isAnd(unsigned i) const { return i >= getAndBegin(); }
+    FlatLit getFanin0(unsigned i) const { return _fanin0[i]; }
+    FlatLit getFanin1(unsigned i) const { return _fanin1[i]; }
+    FlatLit getPoLit(unsigned i) const { return _poLits[i]; }
+    FlatLit getRiLit(unsigned i) const { return _riLits[i]; }
+    unsigned getGid(unsigned i) const { return _gids[i]; }
+    // AND gates of level l (1 <= l < getNumLevels()):
+    // [getLevelBegin(l), getLevelBegin(l + 1))
+    unsigned getNumLevels() const { return _levelStart.size(); }
+    unsigned getLevelBegin(unsigned l) const {
+        return (l < _levelStart.size()) ? _levelStart[l] : getNumObjs();
+    }
+    // UINT_MAX if the gate is not in the flat AIG
+    unsigned getIdx(unsigned gid) const {
+        return (gid < _gid2Idx.size()) ? _gid2Idx[gid] : UINT_MAX;
+    }
+
+    static unsigned litIdx(FlatLit l) { return l >> 1; }
+    static bool litInv(FlatLit l) { return l & 1; }
+
+    // Simulation
+    // values[i * nWords + w] ==> word w of object i; the PI and RO rows
+    // must be set by the caller. Row 0 (const 0) is cleared here. With
+    // nThreads > 1, the threads are created for this call only; use a
+    // CirSimPool to simulate many times on the same threads.
+    void simulate(vector<size_t>& values, size_t nWords,
+                  unsigned nThreads = 1) const;
+    static size_t getLitValue(const vector<size_t>& values, FlatLit l,
+                              size_t nWords, size_t w) {
+        size_t v = values[litIdx(l) * nWords + w];
+        return litInv(l) ? ~v : v;
+    }
+
+    // Ternary (0/1/X) simulation: two rows per object,
+    // values[(i * 2 + b) * nWords + w] ==> word w of object i, where row
+    // b = 0 is "may be 0" and b = 1 is "may be 1"; i.e. 0 = (1, 0),
+    // 1 = (0, 1) and X = (1, 1). The PI and RO rows must be set by the
+    // caller. A complemented literal swaps the two rows. The AND gates are
+    // evaluated serially in object order, without the level split of
+    // simulate().
+    void simulateTernary(vector<size_t>& values, size_t nWords) const;
+    static size_t getLitMay0(const vector<size_t>& values, FlatLit l,
+                             size_t nWords, size_t w) {
+        return values[(litIdx(l) * 2 + litInv(l)) * nWords + w];
+    }
+    static size_t getLitMay1(const vector<size_t>& values, FlatLit l,
+                             size_t nWords, size_t w) {
+        return values[(litIdx(l) * 2 + !litInv(l)) * nWords + w];
+    }
+
+    // SAT encoding (one time frame)
+    // vars[i] ==> the SAT variable of object i; the PIs and ROs are free
+    void addToSolver(SolverV& solver, vector<int>& vars) const;
+
+private:
+    unsigned _numPIs;
+    unsigned _numLATCHs;
+    IdList _gids;              // object index -> gate ID
+    IdList _gid2Idx;           // gate ID -> object index
+    vector<FlatLit> _fanin0;   // valid for AND objects only
+    vector<FlatLit> _fanin1;   // valid for AND objects only
+    vector<FlatLit> _poLits;   // fanin literal of each PO
+    vector<FlatLit> _riLits;   // fanin literal of each RI (next state)
+    IdList _levelStart;        // first AND object of each level; [0] unused
+
+    FlatLit toFlatLit(const CirGateV& v) const;
+    void simulateAnds(size_t* val, size_t nWords, unsigned begin,
+                      unsigned end) const;
+
+    friend class CirSimPool;
+};
+
+//------------------------------------------------------------------------
+//   class CirSimPool
+//------------------------------------------------------------------------
+// Level-parallel simulation of a CirFlatAig on nThreads threads (the
+// caller and nThreads - 1 workers), which stay alive across simulate()
+// calls, e.g. over the cycles of CirMgr::seqSim(). The levels are grouped
+// into phases with a barrier after each: a level large enough is a phase
+// split among the threads, and a run of consecutive smaller levels is one
+// phase done by the caller alone. If no level is large enough, no worker
+// is created and everything runs in the caller.
+//
+class CirSimPool {
+public:
+    CirSimPool(const CirFlatAig& aig, unsigned nThreads);
+    ~CirSimPool();
+
+    unsigned getNumThreads() const { return _nThreads; }
+    unsigned getNumPhases() const { return _split.size(); }
+
+    // Same as CirFlatAig::simulate()
+    void simulate(vector<size_t>& values, size_t nWords);
+
+private:
+    const CirFlatAig& _aig;
+    unsigned _nThreads;
+    IdList _phaseStart;        // phase k: [_phaseStart[k], _phaseStart[k+1])
+    vector<bool> _split;       // phase k is split among the threads
+    vector<thread> _workers;
+    CirSimBarrier* _barrier;
+    mutex _mutex;
+    condition_variable _cond;
+    size_t _job;               // # of simulate() calls so far
+    bool _stop;
+    size_t* _val;              // the job: values and # words
+    size_t _nWords;
+
+    void work(unsigned t);
+    void simulatePhases(unsigned t) const;
+};
+
+//------------------------------------------------------------------------
+//   class CirEventSim
+//------------------------------------------------------------------------
+// Event-driven (incremental) simulation over a CirFlatAig. The first
+// propagate() evaluates every AND gate; after that only the fanout cones of
+// the inputs (PIs/ROs) whose values changed are re-evaluated. The pending
+// gates are kept in one bucket per level, so each gate is evaluated at most
+// once per propagate() and always after its fanins.
+//
+class CirEventSim {
+public:
+    CirEventSim(const CirFlatAig& aig, size_t nWords);
+    ~CirEventSim() {}
+
+    // Set the nWords words of a PI/RO object; schedules its fanouts if
+    // the value changes
+    void setInput(unsigned idx, const size_t* words);
+    // return the # of AND gates evaluated
+    size_t propagate();
+
+    const vector<size_t>& getValues() const { return _values; }
+    const size_t* getValue(unsigned idx) const {
+        return &_values[size_t(idx) * _nWords];
+    }
+    // objects (inputs included) whose values changed in the last propagate()
+    const IdList& getChanged() const { return _changed; }
+    unsigned getLevel(unsigned idx) const { return _levels[idx]; }
+
+    // Statistics
+    size_t getNumEvals() const { return _numEvals; }
+    size_t getNumRounds() const { return _numRounds; }
+
+private:
+    const CirFlatAig& _aig;
+    size_t _nWords;
+    vector<size_t> _values;    // _values[idx * _nWords + w]
+    IdList _levels;            // 0 for const/PI/RO
+    IdList _foStart;           // fanouts of idx: [_foStart[idx], _foStart[idx+1])
+    IdList _fanouts;           // AND objects only
+    vector<IdList> _buckets;   // pending AND gates of each level
+    vector<bool> _queued;
+    IdList _changed;
+    bool _initialized;
+    bool _newRound;            // _changed is from the last propagate()
+    size_t _numEvals;
+    size_t _numRounds;
+
+    void schedule(unsigned idx);
+    void startRound() {
+        if (_newRound) _changed.clear();
+        _newRound = false;
+    }
+};
+
+#endif  // CIR_FLAT_H
@@ -0,0 +1,241 @@
+/****************************************************************************
+  FileName     [ cirFraig.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define cir FRAIG functions ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+#include "SolverV.h"
+#include "cirCut.h"
+#include "cirDef.h"
+#include "cirFlat.h"
+#include "cirGate.h"
+#include "cirMgr.h"
+#include "util.h"
+
+using namespace std;
+
+// Conflict limit of each SAT call; a pair that hits it is left unmerged
+#define CIR_FRAIG_EFFORT 1000
+// Leaves and leaf expansions of the common cut of a pair in cutCheckFEC()
+#define CIR_FRAIG_CUT_LEAVES CIR_CUTSIM_MAX_LEAVES
+#define CIR_FRAIG_CUT_EXPANDS 64
+
+/*******************************************/
+/*   Public member functions about fraig   */
+/*******************************************/
+// Functionally reduce the AIG:
+// (1) strash
+// (2) random simulation for the FEC groups (if not simulated yet)
+// (3) check each AIG gate against the first gate of its FEC group in
+//     topological order: by exhaustive simulation over a common cut first,
+//     then in one incremental SolverV. A proven pair is merged; a
+//     counter-example becomes a simulation pattern, and every
+//     CIR_SIM_PATTERNS of them refine the FEC groups.
+void CirMgr::fraig() {
+    strash();
+    if (_fecGrpStart.empty() && !isFlag(NO_FEC)) randomSim();
+    if (getNumFECGrps() == 0) {
+        cout << "Fraig: no FEC group to be proved." << endl;
+        return;
+    }
+
+    // One CNF copy of the whole AIG; each check only adds a miter
+    const CirFlatAig& flat = getFlatAig();
+    SolverV solver;
+    vector<int> vars;
+    flat.addToSolver(solver, vars);
+
+    IdList order(getNumTots(), UINT_MAX);  // topological order; const 0 first
+    order[0] = 0;
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i)
+        order[_dfsList[i]->getGid()] = i + 1;
+    IdList reps;
+    computeFECReps(order, reps);
+
+    const size_t nIns = flat.getAndBegin() - 1;  // PIs and ROs
+    vector<size_t> patterns(nIns * CIR_SIM_WORDS, 0);
+    unsigned nPatterns = 0;
+    size_t nProved = 0, nCexs = 0, nAborts = 0, nCuts = 0;
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        CirGate* g = _dfsList[i];
+        if (!g->isAig() || !g->isFEC() || g->getEqGate() != 0) continue;
+        unsigned repLit = reps[g->getFECId() / 2];
+        CirGate* rep    = litId2Gate(repLit);
+        if (rep == g) continue;
+        bool inv = (g->getFECId() & 1) != (repLit & 1);
+        int ret  = cutCheckFEC(rep, g, inv, &patterns[0], nPatterns);
+        if (ret >= 0) ++nCuts;
+        else ret = satCheckFEC(solver, vars, rep, g, inv, &patterns[0], nPatterns);
+        if (ret > 0) {
+            g->merge("Fraig", rep, inv);
+            ++nProved;
+        } else if (ret == 0) {
+            ++nCexs;
+            if (++nPatterns == CIR_SIM_PATTERNS) {
+                updateFECbySatPattern(&patterns[0]);
+                computeFECReps(order, reps);
+                nPatterns = 0;
+            }
+        } else
+            ++nAborts;
+    }
+    cout << "Fraig: " << nProved << " proved, " << nCexs << " disproved, "
+         << nAborts << " aborted; " << nCuts << " decided by cut simulation"
+         << endl;
+
+    // The circuit changes ==> the FEC groups are no longer valid
+    clearFECGrps();
+    unsetFlag(NO_FEC);
+    simplifyByEQ();
+}
+
+/********************************************/
+/*   Private member functions about fraig   */
+/********************************************/
+// reps[i] = litId of the first (in topological order) unmerged gate of
+// FEC group i
+void CirMgr::computeFECReps(const IdList& order, IdList& reps) const {
+    reps.assign(getNumFECGrps(), UINT_MAX);
+    for (size_t i = 0, n = getNumFECGrps(); i < n; ++i) {
+        unsigned best = UINT_MAX;
+        for (size_t j = 0, m = getFECGrpSize(i); j < m; ++j) {
+            unsigned lit = getFECLit(i, j);
+            CirGate* g   = litId2Gate(lit);
+            if (g->getEqGate() != 0 || order[g->getGid()] >= best) continue;
+            best    = order[g->getGid()];
+            reps[i] = lit;
+        }
+    }
+}
+
+// Check if a == (b ^ inv) under the assumption of a fresh miter variable
+// return 1 if proved, 0 if disproved (the counter-example is recorded as
+// pattern "bit" in patterns), or -1 if aborted
+int CirMgr::satCheckFEC(SolverV& solver, const vector<int>& vars, CirGate* a,
+                        CirGate* b, bool inv, SimPattern patterns, unsigned bit) {
+    const CirFlatAig& flat = getFlatAig();
+    Lit la = mkLit(vars[flat.getIdx(a->getGid())]);
+    Lit lb = mkLit(vars[flat.getIdx(b->getGid())], inv);
+    Lit lx = mkLit(solver.newVar());
+    // x ==> (a != b)
+    solver.addTernary(~lx, la, lb);
+    solver.addTernary(~lx, ~la, ~lb);
+
+    vec<Lit> assumps;
+    assumps.push(lx);
+    solver._conflictNum = CIR_FRAIG_EFFORT;
+    solver._aborted     = false;
+    bool sat            = solver.solve(assumps);
+    bool aborted        = solver._aborted;
+    if (sat) getSatAssignment(solver, vars, patterns, bit);
+    solver.addUnit(~lx);  // retire the miter
+    if (sat) return 0;
+    if (aborted) return -1;
+    // keep the proven equivalence for the later checks
+    solver.addBinary(~la, lb);
+    solver.addBinary(la, ~lb);
+    return 1;
+}
+
+// Check if a == (b ^ inv) without SAT: the truth tables over a common cut
+// of at most CIR_FRAIG_CUT_LEAVES leaves, grown from {a, b} by expanding
+// the leaf that adds the fewest new leaves. Equal tables prove the pair;
+// different ones disprove it only if all the leaves are PIs or ROs (free
+// inputs), and a differing minterm is recorded as pattern "bit".
+// return 1 if proved, 0 if disproved, or -1 if not decided
+int CirMgr::cutCheckFEC(CirGate* a, CirGate* b, bool inv, SimPattern patterns,
+                        unsigned bit) {
+    IdList leaves;
+    if (!a->isConst()) leaves.push_back(a->getGid());
+    if (!b->isConst()) leaves.push_back(b->getGid());
+    for (unsigned k = 0; k < CIR_FRAIG_CUT_EXPANDS; ++k) {
+        size_t best = leaves.size(), bestNew = UINT_MAX;
+        for (size_t i = 0, n = leaves.size(); i < n; ++i) {
+            const CirGate* g = _totGateList[leaves[i]];
+            if (!g->isAig()) continue;
+            const CirGate *g0 = g->getIn0Gate(), *g1 = g->getIn1Gate();
+            size_t nNew = 0;
+            if (!g0->isConst() &&
+                find(leaves.begin(), leaves.end(), g0->getGid()) == leaves.end())
+                ++nNew;
+            if (g1 != g0 && !g1->isConst() &&
+                find(leaves.begin(), leaves.end(), g1->getGid()) == leaves.end())
+                ++nNew;
+            if (n - 1 + nNew <= CIR_FRAIG_CUT_LEAVES && nNew < bestNew) {
+                best    = i;
+                bestNew = nNew;
+            }
+        }
+        if (best == leaves.size()) break;
+        const CirGate* g = _totGateList[leaves[best]];
+        leaves.erase(leaves.begin() + best);
+        for (unsigned j = 0; j < 2; ++j) {
+            const CirGate* f = j ? g->getIn1Gate() : g->getIn0Gate();
+            if (!f->isConst() &&
+                find(leaves.begin(), leaves.end(), f->getGid()) == leaves.end())
+                leaves.push_back(f->getGid());
+        }
+    }
+
+    // the table of a is only valid until the next cutSim()
+    const unsigned nLeaves = leaves.size();
+    const size_t nWords    = CirCutSim::getNumWords(nLeaves);
+    const size_t* t        = cutSim(a, leaves.data(), nLeaves);
+    if (t == 0) return -1;
+    const vector<size_t> ta(t, t + nWords);
+    const size_t* tb = cutSim(b, leaves.data(), nLeaves);
+    if (tb == 0) return -1;
+    const size_t m = inv ? ~size_t(0) : 0;
+    size_t w       = 0;
+    while (w < nWords && ta[w] == (tb[w] ^ m)) ++w;
+    if (w == nWords) return 1;
+    for (unsigned i = 0; i < nLeaves; ++i) {
+        const CirGate* g = _totGateList[leaves[i]];
+        if (!g->isPi() && !g->isRo()) return -1;
+    }
+    // the lowest differing bit is below 2^nLeaves even if nLeaves < 6
+    const size_t diff    = ta[w] ^ tb[w] ^ m;
+    const size_t minterm = w * 64 + __builtin_ctzll(diff);
+    // the other inputs are random, for more refinement by the pattern
+    const CirFlatAig& flat = getFlatAig();
+    const size_t pw = bit / 64, mask = size_t(1) << (bit % 64);
+    for (size_t i = 1, n = flat.getAndBegin(); i < n; ++i)
+        if (rnGen(2)) patterns[(i - 1) * CIR_SIM_WORDS + pw] |= mask;
+    for (unsigned i = 0; i < nLeaves; ++i) {
+        size_t& p = patterns[(flat.getIdx(leaves[i]) - 1) * CIR_SIM_WORDS + pw];
+        p         = ((minterm >> i) & 1) ? (p | mask) : (p & ~mask);
+    }
+    return 0;
+}
+
+// Set bit "bit" of the PI/RO words in patterns (CIR_SIM_WORDS per input,
+// PIs first) by the satisfying assignment
+void CirMgr::getSatAssignment(SolverV& solver, const vector<int>& vars,
+                              SimPattern patterns, unsigned bit) const {
+    const size_t w = bit / 64, mask = size_t(1) << (bit % 64);
+    for (size_t i = 1, n = _flatAig->getAndBegin(); i < n; ++i)
+        if (solver.model[vars[i]] == gv_l_True)
+            patterns[(i - 1) * CIR_SIM_WORDS + w] |= mask;
+}
+
+// Simulate the counter-examples (PIs and ROs as free inputs) and refine the
+// FEC groups with them; patterns are cleared afterwards
+void CirMgr::updateFECbySatPattern(SimPattern patterns) {
+    const CirFlatAig& flat = getFlatAig();
+    const size_t nIns      = flat.getAndBegin() - 1;
+    vector<size_t> values(size_t(flat.getNumObjs()) * CIR_SIM_WORDS, 0);
+    for (size_t i = 0, n = nIns * CIR_SIM_WORDS; i < n; ++i) {
+        values[CIR_SIM_WORDS + i] = patterns[i];
+        patterns[i]               = 0;
+    }
+    flat.simulate(values, CIR_SIM_WORDS);
+    setFlatPValues(flat, values, CIR_SIM_WORDS, 0);
+    refineFEC();
+    finalizeFEC();
+}
@@ -51,39 +51,27 @@ ostream& operator<<(ostream& os, const CirGateV& gv) {
 /**************************************/
 /*   class CirGate member functions   */
 /**************************************/
-void CirPiGate::printGate() const {
-    cout << setw(4) << left << getTypeStr() << _gid;
-    if (_name) cout << " (" << _name << ")";
-    cout << endl;
-}
-
-void CirRoGate::printGate() const {
-    cout << setw(4) << left << getTypeStr() << _gid << " " << _in0;
-    if (_name) cout << " (" << _name << ")";
-    cout << endl;
-}
-
-void CirPoGate::printGate() const {
-    cout << setw(4) << left << getTypeStr() << _gid << " " << _in0;
-    if (_name) cout << " (" << _name << ")";
-    cout << endl;
+string CirGate::getTypeStr() const {
+    static const char* typeStr[TOT_GATE] = {"UNDEF", "PI", "PO", "AIG",
+                                            "CONST", "RO", "RI"};
+    return typeStr[_type];
 }
 
-void CirRiGate::printGate() const {
-    cout << setw(4) << left << getTypeStr() << _gid << " " << _in0;
-    if (_name) cout << " (" << _name << ")";
+// PI/RO/PO/RI: type, ID, fanin and name; AIG: type, ID and fanins
+void CirGate::printGate() const {
+    if (isUndef()) {
+        cerr << "CirGate::printGate() is called on an UNDEF gate!!" << endl;
+        exit(-1);
+    }
+    cout << setw(4) << left << getTypeStr() << _gid;
+    const unsigned nFanins = getNumFanins();
+    if (nFanins >= 1) cout << " " << _in0;
+    if (nFanins >= 2) cout << " " << _in1;
+    if (!isAig() && !isConst())
+        if (const char* name = cirMgr->getName(_gid)) cout << " (" << name << ")";
     cout << endl;
 }
 
-void CirAigGate::printGate() const {
-    cout << setw(4) << left << getTypeStr() << _gid << " " << _in0 << " "
-         << _in1 << endl;
-}
-
-void CirConstGate::printGate() const {
-    cout << setw(4) << left << getTypeStr() << _gid << endl;
-}
-
 void CirGate::reportGate() const {
     unsigned w = 80;
     for (unsigned i = 0; i < w; ++i) cout << '=';
@@ -91,8 +79,8 @@ void CirGate::reportGate() const {
 
     // Printing gate info
     cout << "= " << getTypeStr() << "(" << _gid << ")";
-    if (getName()) cout << "\"" << getName() << "\"";
-    cout << ", line " << _lineNo << endl;
+    if (const char* name = cirMgr->getName(_gid)) cout << "\"" << name << "\"";
+    cout << ", line " << cirMgr->getLineNo(_gid) << endl;
 
     // Printing FEC Pairs
     // cout << "= FECs:";
@@ -114,6 +102,14 @@ void CirGate::reportGate() const {
     cout << endl;
 }
 
+// This gate is replaced by (g ^ inv); the fanins that point to this gate
+// are redirected later by CirMgr::simplifyByEQ()
+void CirGate::merge(const string& str, CirGate* g, bool inv) {
+    cout << str << ": " << g->getGid() << " merging " << (inv ? "!" : "")
+         << _gid << "..." << endl;
+    setEqGate(g, inv);
+}
+
 void CirGate::reportFanin(int level) const {
     assert(level >= 0);
     setGlobalRef();
@@ -124,7 +120,7 @@ void CirGate::reportFaninRecur(int level, int repLevel, bool isInv) const {
     if (repLevel > 0) cout << setw(repLevel * 2) << ' ';
     cout << (isInv ? "!" : "") << getTypeStr() << " " << _gid;
 #ifndef NDEBUG
-    cout << " " << (_pValue() & size_t(0x1));
+    cout << " " << (cirMgr->getPValue(_gid).getWord(0) & size_t(0x1));
 #endif
     if (level == repLevel) {
         cout << endl;
@@ -159,7 +155,7 @@ void CirGate::reportFanoutRecur(int level, int repLevel, bool isInv) const {
         return;
     }
     assert(level > repLevel);
-    GateList& fanouts = cirMgr->getFanouts(_gid);
+    const GateList& fanouts = cirMgr->getFanouts(_gid);
     size_t nFanouts   = fanouts.size();
     if (isGlobalRef() && nFanouts != 0) {
         cout << " (*)" << endl;
@@ -185,31 +181,13 @@ void CirGate::reportFanoutRecur(int level, int repLevel, bool isInv) const {
 }
 
 // set in0 by the cirgate
-void CirPoGate::setIn0(CirGate* faninGate, bool inv) {
-    CirGateV gateV = size_t(faninGate);
-    gateV.setInv(inv);
-    setIn0(gateV());
-}
-
-void CirRoGate::setIn0(CirGate* faninGate, bool inv) {
-    CirGateV gateV = size_t(faninGate);
-    gateV.setInv(inv);
-    setIn0(gateV());
-}
-
-void CirRiGate::setIn0(CirGate* faninGate, bool inv) {
-    CirGateV gateV = size_t(faninGate);
-    gateV.setInv(inv);
-    setIn0(gateV());
-}
-
-void CirAigGate::setIn0(CirGate* faninGate, bool inv) {
+void CirGate::setIn0(CirGate* faninGate, bool inv) {
     CirGateV gateV = size_t(faninGate);
     gateV.setInv(inv);
     setIn0(gateV());
 }
 
-void CirAigGate::setIn1(CirGate* faninGate, bool inv) {
+void CirGate::setIn1(CirGate* faninGate, bool inv) {
     CirGateV gateV = size_t(faninGate);
     gateV.setInv(inv);
     setIn1(gateV());
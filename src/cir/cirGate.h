@@ -16,6 +16,10 @@
 #include <vector>
 
 #include "cirDef.h"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 // #include "gvSat.h"
 
 using namespace std;
@@ -27,39 +31,97 @@ class CirGate;
 //------------------------------------------------------------------------
 //   Define classes
 //------------------------------------------------------------------------
+// Parallel simulation value of a gate: CIR_SIM_PATTERNS patterns, one bit
+// each. The word loops below are the whole simulation kernel; explicit
+// AVX-512/AVX2 code is used when the target supports it and the width is a
+// multiple of the vector size, otherwise the plain loops are used.
 class CirPValue {
 public:
-    CirPValue(size_t v = 0) : _pValue(v) {}
+    CirPValue(size_t v = 0) {
+        for (size_t w = 0; w < CIR_SIM_WORDS; ++w) _pValue[w] = v;
+    }
 
     void rand();
+    void setWords(const size_t* words) {
+        for (size_t w = 0; w < CIR_SIM_WORDS; ++w) _pValue[w] = words[w];
+    }
+    size_t getWord(size_t w) const { return _pValue[w]; }
+    bool getBit(size_t i) const { return (_pValue[i >> 6] >> (i & 63)) & 1; }
+
+    // this = (a ^ inv)
+    inline void setBuf(const CirPValue& a, bool ia) {
+        const size_t ma = ia ? ~size_t(0) : 0;
+        for (size_t w = 0; w < CIR_SIM_WORDS; ++w)
+            _pValue[w] = a._pValue[w] ^ ma;
+    }
+    // this = (a ^ ia) & (b ^ ib)
+    inline void setAnd(const CirPValue& a, bool ia,
+                       const CirPValue& b, bool ib) {
+#if defined(__AVX512F__) && (CIR_SIM_WORDS % 8 == 0)
+        const __m512i ma = _mm512_set1_epi64(ia ? -1 : 0);
+        const __m512i mb = _mm512_set1_epi64(ib ? -1 : 0);
+        for (size_t w = 0; w < CIR_SIM_WORDS; w += 8) {
+            __m512i va = _mm512_loadu_si512(a._pValue + w);
+            __m512i vb = _mm512_loadu_si512(b._pValue + w);
+            _mm512_storeu_si512(_pValue + w,
+                                _mm512_and_si512(_mm512_xor_si512(va, ma),
+                                                 _mm512_xor_si512(vb, mb)));
+        }
+#elif defined(__AVX2__) && (CIR_SIM_WORDS % 4 == 0)
+        const __m256i ma = _mm256_set1_epi64x(ia ? -1 : 0);
+        const __m256i mb = _mm256_set1_epi64x(ib ? -1 : 0);
+        for (size_t w = 0; w < CIR_SIM_WORDS; w += 4) {
+            __m256i va = _mm256_loadu_si256((const __m256i*)(a._pValue + w));
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(b._pValue + w));
+            _mm256_storeu_si256((__m256i*)(_pValue + w),
+                                _mm256_and_si256(_mm256_xor_si256(va, ma),
+                                                 _mm256_xor_si256(vb, mb)));
+        }
+#else
+        const size_t ma = ia ? ~size_t(0) : 0;
+        const size_t mb = ib ? ~size_t(0) : 0;
+        for (size_t w = 0; w < CIR_SIM_WORDS; ++w)
+            _pValue[w] = (a._pValue[w] ^ ma) & (b._pValue[w] ^ mb);
+#endif
+    }
 
-    inline size_t operator()() const { return _pValue; }
-    inline CirPValue operator~() const { return ~_pValue; }
+    // hash key (for FEC refinement)
+    inline size_t operator()() const {
+        size_t h = _pValue[0];
+        for (size_t w = 1; w < CIR_SIM_WORDS; ++w)
+            h = (h * 0x9e3779b97f4a7c15ULL) ^ _pValue[w];
+        return h;
+    }
+    inline CirPValue operator~() const {
+        CirPValue v;
+        v.setBuf(*this, true);
+        return v;
+    }
     inline CirPValue operator&(const CirPValue& p) const {
-        size_t v = _pValue & p._pValue;
+        CirPValue v;
+        v.setAnd(*this, false, p, false);
         return v;
     }
     inline CirPValue& operator&=(const CirPValue& v) {
-        _pValue &= v._pValue;
-        return *this;
-    }
-    inline CirPValue& operator=(const CirPValue& v) {
-        _pValue = v._pValue;
+        setAnd(*this, false, v, false);
         return *this;
     }
     inline bool operator==(const CirPValue& v) const {
-        return (_pValue == v._pValue);
+        for (size_t w = 0; w < CIR_SIM_WORDS; ++w)
+            if (_pValue[w] != v._pValue[w]) return false;
+        return true;
     }
 
     friend ostream& operator<<(ostream& os, const CirPValue& v);
 
 private:
-    size_t _pValue;
+    size_t _pValue[CIR_SIM_WORDS];
 };
 
 class CirGateV {
 public:
     CirGateV(size_t v = 0) : _gateV(v) {}
+    CirGateV(CirGate* g, bool inv) : _gateV(size_t(g) + (inv ? AIG_NEG_FANIN : 0)) {}
 
     size_t operator()() const { return _gateV; }
     CirGate* gate() const { return (CirGate*)(_gateV & AIG_PTR_MASK); }
@@ -77,6 +139,7 @@ public:
     bool operator==(const CirGateV& v) const { return (_gateV == v._gateV); }
     bool operator!=(const CirGateV& v) const { return (_gateV != v._gateV); }
     bool operator<(const CirGateV& v) const { return (_gateV < v._gateV); }
+    CirGateV operator~() const { return (_gateV ^ AIG_NEG_FANIN); }
 
     // inv ==> to reverse phase
     void set(CirGate* g, bool inv) {
@@ -97,38 +160,54 @@ private:
     size_t _gateV;
 };
 
+// A gate record only keeps what the hot loops touch: the type tag, the
+// ID, the FEC/traversal marks and the fanin literals. The fanins are kept
+// in CirGate itself (unused ones are 0) and there is no virtual function:
+// the per-type code (genDfsList(), printGate(), ...) dispatches on the
+// type tag. The subclasses add no data. Every gate is 40 bytes.
+// _fecId, _ref and _eqGate deliberately stay in the record. DFS, FEC
+// refinement, fraig and rewriting read them on every gate visit, and
+// setEqGate() follows the _eqGate chains gate by gate.
+// The data that most gates never use or that only the simulation needs are
+// kept in side tables of CirMgr, indexed by the gate ID:
+//    names        ==> CirMgr::getName() / setName()
+//    line numbers ==> CirMgr::getLineNo() (AAG files only)
+//    sim values   ==> CirMgr::getPValue() (allocated by the simulation)
 class CirGate {
 public:
-    // CirGate(unsigned g, unsigned l) : _gid(g), _lineNo(l), _fecId(UINT_MAX),
-    //                                   _ref(0), _pValue(0), _eqGate(0), _satVar(0) {}
-    CirGate(unsigned g, unsigned l) : _gid(g), _lineNo(l), _fecId(UINT_MAX),
-                                      _ref(0), _pValue(0), _eqGate(0) {}
-    virtual ~CirGate() {}
+    CirGate(unsigned g, GateType t, size_t i = 0)
+        : _gid(g), _type(t), _fecId(UINT_MAX), _ref(0), _in0(i), _in1(0),
+          _eqGate(0) {}
+    ~CirGate() {}
 
     // Basic access methods
-    //   void setGid(unsigned i) { _gid = i; }
-    //   void setLineNo(unsigned l) { _lineNo = l; }
     unsigned getGid() const { return _gid; }
-    unsigned getLineNo() const { return _lineNo; }
-    virtual GateType getType() const  = 0;
-    virtual string getTypeStr() const = 0;
-    virtual void setIn0(CirGate*, bool inv){};
-    virtual void setIn1(CirGate*, bool inv){};
-    virtual CirGateV getIn0() const { return 0; }
-    virtual CirGateV getIn1() const { return 0; }
-    virtual CirGate* getIn0Gate() const { return 0; }
-    virtual CirGate* getIn1Gate() const { return 0; }
-    virtual unsigned getNumFanins() const { return 0; }
-    virtual char* getName() const { return 0; }
-    virtual bool isPi() const { return false; }
-    virtual bool isPo() const { return false; }
-    virtual bool isAig() const { return false; }
-    virtual bool isConst() const { return false; }
-    virtual bool isUndef() const { return false; }
+    GateType getType() const { return GateType(_type); }
+    string getTypeStr() const;
+    // Fanins: 2 for AIG; 1 (_in0) for PO, RI and RO; none otherwise
+    CirGateV getIn0() const { return _in0; }
+    CirGateV getIn1() const { return _in1; }
+    CirGate* getIn0Gate() const { return _in0.gate(); }
+    CirGate* getIn1Gate() const { return _in1.gate(); }
+    unsigned getNumFanins() const {
+        if (_type == AIG_GATE) return 2;
+        return (_type == PO_GATE || _type == RI_GATE || _type == RO_GATE) ? 1 : 0;
+    }
+    void setIn0(size_t i) { _in0 = i; }
+    void setIn1(size_t i) { _in1 = i; }
+    void setIn0(CirGate* faninGate, bool inv = false);
+    void setIn1(CirGate* faninGate, bool inv = false);
+    bool isPi() const { return _type == PI_GATE; }
+    bool isPo() const { return _type == PO_GATE; }
+    bool isRo() const { return _type == RO_GATE; }
+    bool isRi() const { return _type == RI_GATE; }
+    bool isAig() const { return _type == AIG_GATE; }
+    bool isConst() const { return _type == CONST_GATE; }
+    bool isUndef() const { return _type == UNDEF_GATE; }
 
     // Methods about circuit construction
-    virtual void genConnections() {}
-    virtual void genDfsList(vector<CirGate*>&) { setToGlobalRef(); }
+    void genConnections();
+    void genDfsList(vector<CirGate*>&);
 
     // Methods about circuit optimization
     // virtual CirGateV optimize(bool phase, GateList&) {
@@ -139,11 +218,6 @@ public:
     // void replace(CirGate*, bool);
     void removeFanout(CirGate*) const;
 
-    // Methods about circuit simulation
-    virtual void pSim() {}
-    void setPValue(const CirPValue& v) { _pValue = v; }
-    const CirPValue& getPValue() const { return _pValue; }
-
     // Methods about FRAIG
     void setFECId(unsigned i) { _fecId = i; }
     void resetFECId() { _fecId = UINT_MAX; }
@@ -163,7 +237,7 @@ public:
     // Var getSatVar() const { return _satVar; }
 
     // Printing functions
-    virtual void printGate() const = 0;
+    void printGate() const;
     void reportGate() const;
     void reportFanin(int level) const;
     void reportFanout(int level) const;
@@ -188,11 +262,12 @@ private:
     void reportFanoutRecur(int, int, bool) const;
 
 protected:
-    unsigned _gid;  // var ID
-    unsigned _lineNo;
+    unsigned _gid;    // var ID
+    unsigned _type;   // GateType
     unsigned _fecId;  // _fecId/2 => FEC ID; _fecId&1 => phase
     mutable unsigned _ref;
-    CirPValue _pValue;
+    CirGateV _in0;
+    CirGateV _in1;
     CirGateV _eqGate;
     // Var _satVar;
 
@@ -200,274 +275,66 @@ protected:
 
     // Protected methods about circuit optimization
     // [Note] The original fanin will become invalid!!
-    virtual void replaceFanin(CirGate*, CirGate*, bool) {}
+    void replaceFanin(CirGate* o, CirGate* n, bool inv) {
+        if (o == _in0.gate()) {
+            _in0.replace(n, inv);
+            if (n->isUndef()) _in0.setFloat();
+        } else {
+            _in1.replace(n, inv);
+            if (n->isUndef()) _in1.setFloat();
+        }
+    }
 };
 
-class CirPiGate : public CirGate {
+class CirPiGate final : public CirGate {
 public:
-    CirPiGate(unsigned g, unsigned l) : CirGate(g, l), _name(0) {}
-    ~CirPiGate() {
-        if (_name) delete[] _name;
-    }
-
-    // Basic access methods
-    GateType getType() const { return PI_GATE; }
-    string getTypeStr() const { return "PI"; }
-    void setName(char* s) { _name = s; }
-    char* getName() const { return _name; }
-    bool isPi() const { return true; }
-
-    // Methods about circuit construction
-    void genDfsList(vector<CirGate*>&);
-
-    // Methods about circuit simulation
-    void setRandPPattern() { _pValue.rand(); }
-
-    // Printing functions
-    void printGate() const;
-
-private:
-    char* _name;
+    CirPiGate(unsigned g) : CirGate(g, PI_GATE) {}
+    ~CirPiGate() {}
 };
 
-class CirPoGate : public CirGate {
+class CirPoGate final : public CirGate {
 public:
-    CirPoGate(unsigned g, unsigned l, size_t i = 0)
-        : CirGate(g, l), _in0(i), _name(0) {}
-    ~CirPoGate() {
-        if (_name) delete[] _name;
-    }
-
-    // Basic access methods
-    GateType getType() const { return PO_GATE; }
-    string getTypeStr() const { return "PO"; }
-    CirGateV getIn0() const { return _in0; }
-    CirGate* getIn0Gate() const { return _in0.gate(); }
-    unsigned getNumFanins() const { return 1; }
-    void setName(char* s) { _name = s; }
-    char* getName() const { return _name; }
-    bool isPo() const { return true; }
-    void setIn0(size_t i) { _in0 = i; }
-    void setIn0(CirGate* faninGate, bool inv = false);
-
-    // Methods about circuit construction
-    void genConnections();
-    void genDfsList(vector<CirGate*>&);
-
-    // Methods about circuit simulation
-    void pSim() {
-        _pValue = _in0.isInv() ? ~(_in0.gate()->getPValue())
-                               : _in0.gate()->getPValue();
-    }
+    CirPoGate(unsigned g, size_t i = 0) : CirGate(g, PO_GATE, i) {}
+    ~CirPoGate() {}
 
     // Methods about circuit optimization
     // CirGateV optimize(bool, GateList&);
-
-    // Printing functions
-    void printGate() const;
-
-private:
-    CirGateV _in0;
-    char* _name;
-
-    // Private methods about circuit optimization
-    // [Note] old must == _in0, DO NOT CHECK!
-    void replaceFanin(CirGate*, CirGate* n, bool inv) {
-        _in0.replace(n, inv);
-        if (n->isUndef()) _in0.setFloat();
-    }
 };
 
-class CirRoGate : public CirGate {
+class CirRoGate final : public CirGate {
 public:
-    CirRoGate(unsigned g, unsigned l, size_t i = 0)
-        : CirGate(g, l), _in0(i), _name(0) {}
-    ~CirRoGate() {
-        if (_name) delete[] _name;
-    }
-
-    // Basic access methods
-    GateType getType() const { return RO_GATE; }
-    string getTypeStr() const { return "RO"; }
-    CirGateV getIn0() const { return _in0; }
-    CirGate* getIn0Gate() const { return _in0.gate(); }
-    unsigned getNumFanins() const { return 1; }
-    void setName(char* s) { _name = s; }
-    char* getName() const { return _name; }
-    bool isRo() const { return true; }
-    void setIn0(size_t i) { _in0 = i; }
-    void setIn0(CirGate* faninGate, bool inv = false);
-
-    // Methods about circuit construction
-    void genDfsList(vector<CirGate*>&);
-
-    // Methods about circuit simulation
-    void pSim() {
-        _pValue = _in0.isInv() ? ~(_in0.gate()->getPValue())
-                               : _in0.gate()->getPValue();
-    }
-    void zInitPPattern() { _pValue = 0; }  // zero initiate the simulattion value
-
-    // Printing functions
-    void printGate() const;
-
-private:
-    CirGateV _in0;
-    char* _name;
-
-    // Private methods about circuit optimization
-    // [Note] old must == _in0, DO NOT CHECK!
-    void replaceFanin(CirGate*, CirGate* n, bool inv) {
-        _in0.replace(n, inv);
-        if (n->isUndef()) _in0.setFloat();
-    }
+    CirRoGate(unsigned g, size_t i = 0) : CirGate(g, RO_GATE, i) {}
+    ~CirRoGate() {}
 };
 
-class CirRiGate : public CirGate {
+class CirRiGate final : public CirGate {
 public:
-    CirRiGate(unsigned g, unsigned l, size_t i = 0)
-        : CirGate(g, l), _in0(i), _name(0) {}
-    ~CirRiGate() {
-        if (_name) delete[] _name;
-    }
-
-    // Basic access methods
-    GateType getType() const { return RI_GATE; }
-    string getTypeStr() const { return "RI"; }
-    CirGateV getIn0() const { return _in0; }
-    CirGate* getIn0Gate() const { return _in0.gate(); }
-    unsigned getNumFanins() const { return 1; }
-    void setName(char* s) { _name = s; }
-    char* getName() const { return _name; }
-    bool isRi() const { return true; }
-    void setIn0(size_t i) { _in0 = i; }
-    void setIn0(CirGate* faninGate, bool inv = false);
-
-    // Methods about circuit construction
-    void genConnections();
-    void genDfsList(vector<CirGate*>&);
-
-    // Methods about circuit simulation
-    void pSim() {
-        _pValue = _in0.isInv() ? ~(_in0.gate()->getPValue())
-                               : _in0.gate()->getPValue();
-    }
+    CirRiGate(unsigned g, size_t i = 0) : CirGate(g, RI_GATE, i) {}
+    ~CirRiGate() {}
 
     // Methods about circuit optimization
     // CirGateV optimize(bool, GateList&);
-
-    // Printing functions
-    void printGate() const;
-
-private:
-    CirGateV _in0;
-    char* _name;
-
-    // Private methods about circuit optimization
-    // [Note] old must == _in0, DO NOT CHECK!
-    void replaceFanin(CirGate*, CirGate* n, bool inv) {
-        _in0.replace(n, inv);
-        if (n->isUndef()) _in0.setFloat();
-    }
 };
 
-class CirAigGate : public CirGate {
+class CirAigGate final : public CirGate {
 public:
-    CirAigGate(unsigned g, unsigned l) : CirGate(g, l), _name(0) {}
-    ~CirAigGate() {
-        if (_name) delete[] _name;
-    }
-    CirGateV getIn0() const { return _in0; }
-    CirGateV getIn1() const { return _in1; }
-    CirGate* getIn0Gate() const { return _in0.gate(); }
-    CirGate* getIn1Gate() const { return _in1.gate(); }
-    unsigned getNumFanins() const { return 2; }
-    void setIn0(size_t i) { _in0 = i; }
-    void setIn1(size_t i) { _in1 = i; }
-    void setIn0(CirGate* faninGate, bool inv = false);
-    void setIn1(CirGate* faninGate, bool inv = false);
-    void setName(char* s) { _name = s; }
-    char* getName() const { return _name; }
-
-    // Basic access methods
-    GateType getType() const { return AIG_GATE; }
-    string getTypeStr() const { return "AIG"; }
-    bool isAig() const { return true; }
-
-    // Methods about circuit construction
-    void genConnections();
-    void genDfsList(vector<CirGate*>&);
+    CirAigGate(unsigned g) : CirGate(g, AIG_GATE) {}
+    ~CirAigGate() {}
 
     // Methods about circuit optimization
     // CirGateV optimize(bool, GateList&);
-
-    // Methods about circuit simulation
-    void pSim() {
-        _pValue = _in0.isInv() ? ~(_in0.gate()->getPValue())
-                               : _in0.gate()->getPValue();
-        _pValue &= _in1.isInv() ? ~(_in1.gate()->getPValue())
-                                : _in1.gate()->getPValue();
-    }
-
-    // Printing functions
-    void printGate() const;
-
-private:
-    CirGateV _in0;
-    CirGateV _in1;
-    char* _name;
-
-    // Private methods about circuit optimization
-    void replaceFanin(CirGate* o, CirGate* n, bool inv) {
-        if (o == _in0.gate()) {
-            _in0.replace(n, inv);
-            if (n->isUndef()) _in0.setFloat();
-        } else {
-            _in1.replace(n, inv);
-            if (n->isUndef()) _in1.setFloat();
-        }
-    }
 };
 
-class CirConstGate : public CirGate {
+class CirConstGate final : public CirGate {
 public:
-    CirConstGate(unsigned g) : CirGate(g, 0) {}  // _satVar = 0
+    CirConstGate(unsigned g) : CirGate(g, CONST_GATE) {}  // _satVar = 0
     ~CirConstGate() {}
-
-    // Basic access methods
-    GateType getType() const { return CONST_GATE; }
-    string getTypeStr() const { return "CONST"; }
-    bool isConst() const { return true; }
-
-    // Methods about circuit construction
-    void genDfsList(vector<CirGate*>&);
-
-    // Printing functions
-    void printGate() const;
-
-private:
-    char* _name;
 };
 
-class CirUndefGate : public CirGate {
+class CirUndefGate final : public CirGate {
 public:
-    CirUndefGate(unsigned g) : CirGate(g, 0) {}
+    CirUndefGate(unsigned g) : CirGate(g, UNDEF_GATE) {}
     ~CirUndefGate() {}
-
-    // Basic access methods
-    GateType getType() const { return UNDEF_GATE; }
-    string getTypeStr() const { return "UNDEF"; }
-    bool isUndef() const { return true; }
-
-    // Methods about circuit construction
-
-    // Printing functions
-    void printGate() const {
-        cerr << "CirUndefGate::printGate() is called!!" << endl;
-        exit(-1);
-    }
-
-private:
 };
 
 struct GateIdCmp {
@@ -18,8 +18,8 @@ bool inputIsPi(const int& gateId) {
  * @brief Parse the primary input of Gia from the ABC
  *
  */
-void parseInput(const int& idx, const int& gateId) {
-    cirMgr->createInput(idx, gateId);
+void parseInput(const int& idx, const int& gateId, string piName) {
+    cirMgr->createInput(idx, gateId, piName);
 }
 
 void parseOutput(const int& idx, const int& gateId, const int& in0Id, const int& inv, string poName) {
@@ -67,17 +67,22 @@ int getAigIn1Cp(const unsigned& idx) { return cirMgr->getAig(idx)->getIn1().isIn
 int getPoIn0Cp(const unsigned& idx) { return cirMgr->getPo(idx)->getIn0().isInv(); }
 int getRiIn0Cp(const unsigned& idx) { return cirMgr->getRi(idx)->getIn0().isInv(); }
 
-void CirMgr::createInput(const int& idx, const int& gateId) {
-    CirPiGate* gate      = new CirPiGate(gateId, 0);
+void CirMgr::createInput(const int& idx, const int& gateId, string piName) {
+    CirPiGate* gate = new CirPiGate(gateId);
+    if (!piName.empty()) {
+        char* n = new char[piName.size() + 1];
+        strcpy(n, piName.c_str());
+        setName(gateId, n);
+    }
     _piList[idx]         = gate;
     _totGateList[gateId] = gate;
 }
 
 void CirMgr::createOutput(const int& idx, const int& gateId, const int& in0Id, const int& inv, string poName) {
-    CirPoGate* gate = new CirPoGate(gateId, 0, in0Id);
+    CirPoGate* gate = new CirPoGate(gateId, in0Id);
     char* n         = new char[poName.size() + 1];
     strcpy(n, poName.c_str());
-    gate->setName(n);
+    setName(gateId, n);
     gate->setIn0(getGate(in0Id), inv);
     _poList[idx]         = gate;
     _totGateList[gateId] = gate;
@@ -87,7 +92,7 @@ int CirMgr::createRo(const int& idx, const int& gateId, const FileType& fileType
     if (fileType == VERILOG) {
         return _roList[idx]->getGid();
     } else if (fileType == AIGER) {
-        CirRoGate* gate      = new CirRoGate(gateId, 0);
+        CirRoGate* gate      = new CirRoGate(gateId);
         _roList[idx]         = gate;
         _totGateList[gateId] = gate;
     }
@@ -95,18 +100,18 @@ int CirMgr::createRo(const int& idx, const int& gateId, const FileType& fileType
 }
 
 void CirMgr::createRi(const int& idx, const int& gateId, const int& in0Id, const int& inv) {
-    CirRiGate* gate = new CirRiGate(gateId, 0, in0Id);
+    CirRiGate* gate = new CirRiGate(gateId, in0Id);
     string str      = to_string(gateId) + "_ns";
     char* n         = new char[str.size() + 1];
     strcpy(n, str.c_str());
-    gate->setName(n);
+    setName(gateId, n);
     gate->setIn0(getGate(in0Id), inv);
     _riList[idx]         = gate;
     _totGateList[gateId] = gate;
 }
 
 void CirMgr::createAig(const int& gateId, const int& in0Id, const int& in0Inv, const int& in1Id, const int& in1Inv) {
-    CirAigGate* gate = new CirAigGate(gateId, 0);
+    CirAigGate* gate = new CirAigGate(gateId);
     gate->setIn0(getGate(in0Id), in0Inv);
     gate->setIn1(getGate(in1Id), in1Inv);
     _totGateList[gateId] = gate;
@@ -126,7 +131,7 @@ void CirMgr::createConst0() {
 
 void CirMgr::createConst1() {
     // CONST1 Gate
-    _const1 = new CirAigGate(getNumTots(), 0);
+    _const1 = new CirAigGate(getNumTots());
     addTotGate(_const1);
     _const1->setIn0(_const0, true);
     _const1->setIn1(_const0, true);
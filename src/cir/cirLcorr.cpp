@@ -0,0 +1,439 @@
+/****************************************************************************
+  FileName     [ cirLcorr.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the latch correspondence (sequential redundancy
+                 removal) ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <cassert>
+#include <climits>
+#include <iostream>
+#include <map>
+
+#include "SolverV.h"
+#include "cirDef.h"
+#include "cirFlat.h"
+#include "cirGate.h"
+#include "cirMgr.h"
+#include "util.h"
+
+using namespace std;
+
+// Representative of the latches proved to be constant 0
+#define CIR_LCORR_CONST UINT_MAX
+// Conflict limit of each SAT call; a latch that hits it leaves its class
+#define CIR_LCORR_EFFORT 10000
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// splitmix64
+static inline size_t lcorrRandWord(size_t& state) {
+    size_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z        = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z        = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline Lit lcorrLit(const vector<Lit>& lits, FlatLit l) {
+    const Lit p = lits[CirFlatAig::litIdx(l)];
+    return CirFlatAig::litInv(l) ? ~p : p;
+}
+
+/**
+ * Unrolls the flat AIG for nFrames time frames: ro[f][i] is the literal of
+ * latch i at frame f (0 <= f <= nFrames), i.e. ro[f + 1] is the next
+ * state of frame f. The latches of frame 0 are 0 if init is set, or free.
+ */
+static void lcorrUnroll(SolverV& solver, const CirFlatAig& flat, Lit fls,
+                        unsigned nFrames, bool init, vector<vector<Lit> >& ro) {
+    const unsigned nLATCHs = flat.getNumLATCHs();
+    ro.assign(nFrames + 1, vector<Lit>(nLATCHs, fls));
+    if (!init)
+        for (unsigned i = 0; i < nLATCHs; ++i) ro[0][i] = mkLit(solver.newVar());
+    vector<Lit> lits(flat.getNumObjs());
+    for (unsigned f = 0; f < nFrames; ++f) {
+        lits[0] = fls;
+        for (unsigned i = 0; i < flat.getNumPIs(); ++i)
+            lits[flat.getPiIdx(i)] = mkLit(solver.newVar());
+        for (unsigned i = 0; i < nLATCHs; ++i) lits[flat.getRoIdx(i)] = ro[f][i];
+        for (unsigned i = flat.getAndBegin(), n = flat.getNumObjs(); i < n; ++i) {
+            const Lit y = mkLit(solver.newVar());
+            const Lit a = lcorrLit(lits, flat.getFanin0(i));
+            const Lit b = lcorrLit(lits, flat.getFanin1(i));
+            // y = a & b
+            solver.addBinary(a, ~y);
+            solver.addBinary(b, ~y);
+            solver.addTernary(~a, ~b, y);
+            lits[i] = y;
+        }
+        for (unsigned i = 0; i < nLATCHs; ++i)
+            ro[f + 1][i] = lcorrLit(lits, flat.getRiLit(i));
+    }
+}
+
+// The state shared by the checks of latchCorr()
+struct LcorrData {
+    LcorrData(const CirFlatAig& f, IdList& r)
+        : flat(f), reps(r), zeros(r.size(), false), values(f.getNumObjs(), 0),
+          val(r.size(), 0),
+          rnState(size_t(rnGen(INT_MAX))), nCexs(0), nAborts(0) {
+        fls = mkLit(solver.newVar());
+        solver.addUnit(~fls);
+    }
+
+    SolverV solver;
+    const CirFlatAig& flat;
+    Lit fls;                // the literal of const 0
+    IdList& reps;           // representative of each latch
+    vector<bool> zeros;     // 0 in all the reachable states (ternary sim)
+    vector<size_t> values;  // one word per flat object
+    vector<size_t> val;     // latch values of the counter-examples
+    size_t rnState;
+    size_t nCexs;
+    size_t nAborts;
+};
+
+// The latches known to be 0 in every reachable state are 0 in all the
+// frames; this only strengthens the assumptions with invariants
+static void lcorrAddZeros(LcorrData& d, const vector<vector<Lit> >& ro) {
+    for (size_t f = 0; f < ro.size(); ++f)
+        for (unsigned i = 0, n = d.zeros.size(); i < n; ++i)
+            if (d.zeros[i] && !(ro[f][i] == d.fls)) d.solver.addUnit(~ro[f][i]);
+}
+
+// Literal that latch i is assumed to be equal to at a frame
+static inline Lit lcorrRepLit(const LcorrData& d, const vector<Lit>& ro,
+                              unsigned i) {
+    return (d.reps[i] == CIR_LCORR_CONST) ? d.fls : ro[d.reps[i]];
+}
+
+static inline bool lcorrModel(const LcorrData& d, Lit l) {
+    return (l == d.fls) ? false : ((d.solver.model[var(l)] == gv_l_True) != sign(l));
+}
+
+// Split the classes by the latch values of the counter-examples: the latches
+// of a class with the same value (one bit per counter-example) stay with
+// each other, led by the first one
+static void lcorrRefine(LcorrData& d) {
+    map<pair<unsigned, size_t>, unsigned> newRep;
+    for (unsigned i = 0, n = d.reps.size(); i < n; ++i) {
+        const unsigned r = d.reps[i];
+        if (r == i) continue;
+        const size_t rv = (r == CIR_LCORR_CONST) ? 0 : d.val[r];
+        if (d.val[i] == rv) continue;
+        d.reps[i] = newRep.insert(make_pair(make_pair(r, d.val[i]), i)).first->second;
+    }
+}
+
+// Bit 0 of d.val gets the latch values of the SAT model at a frame. The
+// states of the frame before it meet all the assumptions, so the other bits
+// are counter-examples as well: they take that state and random PIs
+static void lcorrGetCex(LcorrData& d, const vector<Lit>& prev,
+                        const vector<Lit>& ro) {
+    const CirFlatAig& flat = d.flat;
+    for (unsigned i = 0, n = flat.getNumPIs(); i < n; ++i)
+        d.values[flat.getPiIdx(i)] = lcorrRandWord(d.rnState);
+    for (unsigned i = 0, n = flat.getNumLATCHs(); i < n; ++i)
+        d.values[flat.getRoIdx(i)] = lcorrModel(d, prev[i]) ? ~size_t(0) : 0;
+    flat.simulate(d.values, 1);
+    for (unsigned i = 0, n = flat.getNumLATCHs(); i < n; ++i) {
+        const size_t v = CirFlatAig::getLitValue(d.values, flat.getRiLit(i), 1, 0);
+        d.val[i]       = (v & ~size_t(1)) | size_t(lcorrModel(d, ro[i]));
+        // the random bits may leave the reachable states
+        if (d.zeros[i]) d.val[i] = 0;
+    }
+}
+
+// Is (latch i == its representative) violated at a frame? With
+// i == UINT_MAX, one SAT call covers all the candidates. On a violation,
+// the classes are refined by the counter-examples.
+// return 1 if it holds, 0 if refined, or -1 if aborted
+static int lcorrCheck(LcorrData& d, const vector<Lit>& prev,
+                      const vector<Lit>& ro, unsigned i, Lit act) {
+    SolverV& solver = d.solver;
+    const Lit x     = mkLit(solver.newVar());
+    vec<Lit> diffs;
+    diffs.push(~x);
+    const unsigned begin = (i == UINT_MAX) ? 0 : i;
+    const unsigned end   = (i == UINT_MAX) ? d.reps.size() : i + 1;
+    for (unsigned j = begin; j < end; ++j) {
+        if (d.reps[j] == j) continue;
+        const Lit a = ro[j], r = lcorrRepLit(d, ro, j);
+        if (a == r) continue;
+        // y ==> (a != r)
+        const Lit y = mkLit(solver.newVar());
+        solver.addTernary(~y, a, r);
+        solver.addTernary(~y, ~a, ~r);
+        diffs.push(y);
+    }
+    if (diffs.size() == 1) return 1;
+    // x ==> some pair differs
+    solver.addClause(diffs);
+    vec<Lit> assumps;
+    assumps.push(x);
+    if (!(act == d.fls)) assumps.push(act);
+    solver._conflictNum = CIR_LCORR_EFFORT;
+    solver._aborted     = false;
+    const bool sat      = solver.solve(assumps);
+    const bool aborted  = solver._aborted;
+    if (sat) {
+        lcorrGetCex(d, prev, ro);
+        lcorrRefine(d);
+        ++d.nCexs;
+    }
+    solver.addUnit(~x);  // retire the check
+    if (sat) return 0;
+    if (aborted) return -1;
+    return 1;
+}
+
+// Check the candidates at a frame until none is violated: all at once
+// first, then one by one if that aborts. A latch that cannot be proved
+// leaves its class (it is never a class leader then). return true if
+// anything is refined
+static bool lcorrCheckFrame(LcorrData& d, const vector<Lit>& prev,
+                            const vector<Lit>& ro, Lit act) {
+    bool refined = false;
+    int ret;
+    while ((ret = lcorrCheck(d, prev, ro, UINT_MAX, act)) == 0) refined = true;
+    if (ret == 1) return refined;
+    for (unsigned i = 0, n = d.reps.size(); i < n; ++i) {
+        if (d.reps[i] == i) continue;
+        while ((ret = lcorrCheck(d, prev, ro, i, act)) == 0) refined = true;
+        if (ret == -1) {
+            ++d.nAborts;
+            d.reps[i] = i;
+            refined   = true;
+        }
+    }
+    return refined;
+}
+
+/******************************************************/
+/*   Public member functions about latch correspondence */
+/******************************************************/
+/**
+ * @brief Merges the latches that are sequentially equivalent.
+ *
+ * (1) The candidate classes come from nCycles cycles of random sequential
+ *     simulation from the reset state (all latches 0): the latches with
+ *     the same trace are put together, and those that stay 0 are
+ *     candidates of const 0. As all the latches reset to 0, a latch can
+ *     only be equal (not complemented) to another one.
+ *     The latches that ternary simulation (all the PIs X) proves to be 0 in
+ *     every reachable state are fixed to 0 in all the frames below, which
+ *     strengthens the induction.
+ * (2) Base case: the candidates must hold in the first depth frames from
+ *     reset (frame 0 holds trivially). A counter-example refines the
+ *     classes.
+ * (3) Induction: with the candidates assumed in frames 0..depth-1 from
+ *     any state, they must hold in frame depth. The unrolling is encoded
+ *     once in an incremental SolverV; the assumption of each round is
+ *     enabled by its own activation literal, which is retired after the
+ *     round. One SAT call checks all the candidates at once, and each
+ *     counter-example refines the classes by the latch values it gives.
+ *     The rounds stop when one round refines nothing.
+ * (4) Every latch is replaced by its representative (or const 0), and the
+ *     latches and the logic left without fanouts are removed.
+ *
+ * @param depth   The induction depth (>= 1).
+ * @param nCycles The # of simulation cycles for the candidates.
+ */
+void CirMgr::latchCorr(unsigned depth, unsigned nCycles) {
+    assert(depth >= 1);
+    updateDfsList();
+    const unsigned nLATCHs = getNumLATCHs(), nAIGs = getNumAIGs();
+    if (nLATCHs == 0) {
+        cout << "LCorr: no latch in the circuit." << endl;
+        return;
+    }
+    const CirFlatAig& flat = getFlatAig();
+    IdList reps(nLATCHs);
+
+    // (1) classes by the hash of the latch traces
+    {
+        const size_t nWords = CIR_SIM_WORDS;
+        vector<size_t> values(size_t(flat.getNumObjs()) * nWords, 0);
+        vector<size_t> sign(nLATCHs, 0), any(nLATCHs, 0);
+        size_t rnState = size_t(rnGen(INT_MAX));
+        for (unsigned c = 0; c < nCycles; ++c) {
+            for (unsigned i = 0; i < flat.getNumPIs(); ++i)
+                for (size_t w = 0; w < nWords; ++w)
+                    values[flat.getPiIdx(i) * nWords + w] = lcorrRandWord(rnState);
+            flat.simulate(values, nWords);
+            vector<size_t> next(size_t(nLATCHs) * nWords);
+            for (unsigned i = 0; i < nLATCHs; ++i)
+                for (size_t w = 0; w < nWords; ++w)
+                    next[i * nWords + w] =
+                        CirFlatAig::getLitValue(values, flat.getRiLit(i), nWords, w);
+            for (unsigned i = 0; i < nLATCHs; ++i)
+                for (size_t w = 0; w < nWords; ++w) {
+                    const size_t v = next[i * nWords + w];
+                    values[flat.getRoIdx(i) * nWords + w] = v;
+                    sign[i] = (sign[i] ^ v) * 0x100000001b3ULL + (sign[i] >> 29);
+                    any[i] |= v;
+                }
+        }
+        map<size_t, unsigned> first;
+        for (unsigned i = 0; i < nLATCHs; ++i) {
+            if (!any[i]) {
+                reps[i] = CIR_LCORR_CONST;
+                continue;
+            }
+            reps[i] = first.insert(make_pair(sign[i], i)).first->second;
+        }
+    }
+    unsigned nCands = 0;
+    for (unsigned i = 0; i < nLATCHs; ++i)
+        if (reps[i] != i) ++nCands;
+    cout << "LCorr: " << nCands << " of " << nLATCHs
+         << " latches are candidates after simulation" << endl;
+
+    LcorrData d(flat, reps);
+    SolverV& solver = d.solver;
+    IdList zeros;
+    getConstLatches(zeros);
+    for (size_t k = 0; k < zeros.size(); ++k) {
+        reps[zeros[k]]    = CIR_LCORR_CONST;
+        d.zeros[zeros[k]] = true;
+    }
+    cout << "LCorr: " << zeros.size()
+         << " latches are const 0 by ternary simulation" << endl;
+
+    // (2) base case
+    if (depth > 1) {
+        vector<vector<Lit> > ro;
+        lcorrUnroll(solver, flat, d.fls, depth - 1, true, ro);
+        lcorrAddZeros(d, ro);
+        // A counter-example at a frame is also one with the refined classes,
+        // so the frames are redone only after a refinement
+        for (bool refined = true; refined;) {
+            refined = false;
+            for (unsigned f = 1; f < depth; ++f)
+                refined |= lcorrCheckFrame(d, ro[f - 1], ro[f], d.fls);
+        }
+    }
+
+    // (3) induction
+    vector<vector<Lit> > ro;
+    lcorrUnroll(solver, flat, d.fls, depth, false, ro);
+    lcorrAddZeros(d, ro);
+    unsigned nRounds = 0;
+    for (bool refined = true; refined; ++nRounds) {
+        const Lit act = mkLit(solver.newVar());
+        for (unsigned f = 0; f < depth; ++f)
+            for (unsigned i = 0; i < nLATCHs; ++i) {
+                if (reps[i] == i) continue;
+                const Lit a = ro[f][i], r = lcorrRepLit(d, ro[f], i);
+                // act ==> (a == r)
+                solver.addTernary(~act, ~a, r);
+                solver.addTernary(~act, a, ~r);
+            }
+        // A counter-example under the assumption of this round is also one
+        // with the refined classes; a refined round is redone, so only the
+        // classes of a round without refinement are proved
+        refined = lcorrCheckFrame(d, ro[depth - 1], ro[depth], act);
+        solver.addUnit(~act);  // retire the assumption of this round
+    }
+
+    // (4) merge
+    unsigned nConsts = 0, nEqs = 0;
+    for (unsigned i = 0; i < nLATCHs; ++i) {
+        if (reps[i] == i) continue;
+        if (reps[i] == CIR_LCORR_CONST) {
+            getRo(i)->setEqGate(_const0, false);
+            ++nConsts;
+        } else {
+            getRo(i)->setEqGate(getRo(reps[i]), false);
+            ++nEqs;
+        }
+    }
+    cout << "LCorr: " << nRounds << " induction rounds, " << d.nCexs
+         << " counter-examples, " << d.nAborts << " aborted" << endl;
+    if (nConsts + nEqs) removeMergedLatches();
+    cout << "LCorr: " << nConsts << " const latches and " << nEqs
+         << " equivalent latches merged; #LATCH " << nLATCHs << " -> "
+         << getNumLATCHs() << ", #AIG " << nAIGs << " -> " << getNumAIGs()
+         << endl;
+}
+
+/*******************************************************/
+/*   Private member functions about latch correspondence */
+/*******************************************************/
+// Redirect the fanouts of the merged ROs, then remove their latches and the
+// AIG gates that only fed the removed RIs
+void CirMgr::removeMergedLatches() {
+    for (unsigned i = 0, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g == 0 || g->getEqGate() != 0) continue;
+        const unsigned nFanins = (g->getType() == RO_GATE) ? 0 : g->getNumFanins();
+        if (nFanins >= 1) {
+            CirGateV in0 = g->getIn0(), v = getEqGateV(in0);
+            if (v != in0) g->setIn0(v.gate(), v.isInv());
+        }
+        if (nFanins >= 2) {
+            CirGateV in1 = g->getIn1(), v = getEqGateV(in1);
+            if (v != in1) g->setIn1(v.gate(), v.isInv());
+        }
+    }
+    vector<char> inDfs(getNumTots(), 0);
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i)
+        inDfs[_dfsList[i]->getGid()] = 1;
+
+    size_t k = 0;
+    for (size_t i = 0, n = _roList.size(); i < n; ++i) {
+        CirRoGate* ro = _roList[i];
+        CirRiGate* ri = _riList[i];
+        if (ro->getEqGate() == 0) {
+            _roList[k]   = ro;
+            _riList[k++] = ri;
+            continue;
+        }
+        _totGateList[ro->getGid()] = 0;
+        _totGateList[ri->getGid()] = 0;
+        deleteName(ro->getGid());
+        deleteName(ri->getGid());
+        delete ro;
+        delete ri;
+    }
+    _roList.resize(k);
+    _riList.resize(k);
+
+    // The FEC groups are no longer valid
+    clearFECGrps();
+    unsetFlag(NO_FEC);
+    genDfsList();
+
+    // The gates that dropped out of the DFS list are deleted once no gate
+    // (in the DFS list or not, e.g. a dangling AND) refers to them
+    IdList refs(getNumTots(), 0);
+    for (unsigned i = 1, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g == 0) continue;
+        for (unsigned j = 0, m = g->getNumFanins(); j < m; ++j)
+            ++refs[(j ? g->getIn1Gate() : g->getIn0Gate())->getGid()];
+    }
+    GateList dead;
+    for (unsigned i = 1, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g != 0 && g->isAig() && g != _const1 && inDfs[i] &&
+            getDfsIdx(i) == UINT_MAX && refs[i] == 0)
+            dead.push_back(g);
+    }
+    while (!dead.empty()) {
+        CirGate* g = dead.back();
+        dead.pop_back();
+        for (unsigned j = 0; j < 2; ++j) {
+            CirGate* f = j ? g->getIn1Gate() : g->getIn0Gate();
+            const unsigned fid = f->getGid();
+            if (--refs[fid] == 0 && f->isAig() && f != _const1 && inDfs[fid] &&
+                getDfsIdx(fid) == UINT_MAX)
+                dead.push_back(f);
+        }
+        deleteAigGate(g);
+    }
+    updateAfterRemoval();
+}
@@ -20,6 +20,7 @@
 
 #include "abcMgr.h"
 #include "cirDef.h"
+#include "cirFlat.h"
 #include "cirGate.h"
 #include "fileType.h"
 #include "util.h"
@@ -130,7 +131,7 @@ parseError(CirParseError err) {
         case REDEF_GATE:
             cerr << "[ERROR] Line " << lineNo + 1 << ": Literal \"" << errInt
                  << "\" is redefined, previously defined as "
-                 << errGate->getTypeStr() << " in line " << errGate->getLineNo()
+                 << errGate->getTypeStr() << " in line " << cirMgr->getLineNo(errGate->getGid())
                  << "!!" << endl;
             break;
         case REDEF_SYMBOLIC_NAME:
@@ -264,27 +265,51 @@ void CirMgr::deleteCircuit() {
         _poList.clear();
     }
     // if (!_totGateList.empty()) { _totGateList.clear(); }
-    if (_fanoutInfo) {
-        delete[] _fanoutInfo;
-        _fanoutInfo = 0;
-    }
+    clearList<vector<GateList> >(_fanoutInfo);
     clearList<IdList>(_undefList);
     clearList<IdList>(_floatList);
     clearList<IdList>(_unusedList);
     clearList<GateList>(_dfsList);
+    clearList<IdList>(_dfsIdx);
+    clearList<IdList>(_levels);
+    clearList<IdList>(_revLevels);
+    clearList<IdList>(_levelGids);
+    clearList<IdList>(_levelStart);
+    _strashHash.reset();
+    if (_flatAig) {
+        delete _flatAig;
+        _flatAig = 0;
+    }
+    _cutSim.reset();
     //   delete _const0;
     //   _const0 = new CirConstGate(0);
-    if (!_fecGrps.empty())
-        for (unsigned i = 0, n = _fecGrps.size(); i < n; ++i)
-            delete _fecGrps[i];
-    clearList<vector<IdList*> >(_fecGrps);
+    clearList<IdList>(_fecLits);
+    clearList<IdList>(_fecGrpStart);
     for (size_t i = 0, np = _fecVector.size(); i < np; ++i)
         delete[] _fecVector[i];
     clearList<SimVector>(_fecVector);
+    for (NameMap::iterator it = _names.begin(); it != _names.end(); ++it)
+        delete[] it->second;
+    _names.clear();
+    clearList<IdList>(_lineNos);
+    clearList<vector<CirPValue> >(_pValues);
     delete _simLog;
     resetFlag();
 }
 
+void CirMgr::setName(unsigned gid, char* name) {
+    char*& n = _names[gid];
+    if (n) delete[] n;
+    n = name;
+}
+
+void CirMgr::deleteName(unsigned gid) {
+    NameMap::iterator it = _names.find(gid);
+    if (it == _names.end()) return;
+    delete[] it->second;
+    _names.erase(it);
+}
+
 bool CirMgr::parseHeader(ifstream& cirin) {
     assert(lineNo == 0 && colNo == 0);
     cirin.getline(buf, 1024);
@@ -340,7 +365,7 @@ bool CirMgr::parseHeader(ifstream& cirin) {
     // _totGateList = new CirGate*[numTots];
     for (unsigned i = 0; i < numTots; ++i)
         _totGateList[i] = 0;
-    _fanoutInfo = new GateList[numTots];
+    _fanoutInfo.assign(numTots, GateList());
 
     _totGateList[0] = _const0;
 
@@ -397,7 +422,8 @@ bool CirMgr::parseLatch(ifstream& cirin) {
         if (!checkWS(false)) return false;
         unsigned litId;
         if (!checkId(litId, "RI")) return false;
-        CirGate* gate      = new CirRiGate(roId, lineNo + 1, litId);
+        CirGate* gate      = new CirRiGate(roId, litId);
+        setLineNo(roId, lineNo + 1);
         _riList[i]         = static_cast<CirRiGate*>(gate);
         _totGateList[riId] = gate;
         if (buf[colNo] != 0) return parseError(MISSING_NEWLINE);
@@ -415,7 +441,8 @@ bool CirMgr::parseOutput(ifstream& cirin) {
         // if (!checkWS(false)) return false;
         unsigned litId;
         // if (!checkId(litId, "PO")) return false;
-        CirGate* gate      = new CirPoGate(poId, lineNo + 1, litId);
+        CirGate* gate      = new CirPoGate(poId, litId);
+        setLineNo(poId, lineNo + 1);
         _poList[i]         = static_cast<CirPoGate*>(gate);
         _totGateList[poId] = gate;
         // if (buf[colNo] != 0) return parseError(MISSING_NEWLINE);
@@ -489,14 +516,14 @@ bool CirMgr::parseSymbol(ifstream& cirin) {
                     return parseError(NUM_TOO_BIG);
                 }
                 CirPiGate* pi = _piList[portId];
-                if (pi->getName()) {
+                if (getName(pi->getGid())) {
                     errMsg = "i";
                     errInt = portId;
                     return parseError(REDEF_SYMBOLIC_NAME);
                 }
                 char* n = new char[strlen(str) + 1];
                 strcpy(n, str);
-                pi->setName(n);
+                setName(pi->getGid(), n);
             } else if (type == 'l') {  // ... NOT supported yet (trying to support now XD)
                 assert(type == 'l');
                 if (portId >= _numDecl[LATCH]) {
@@ -506,20 +533,21 @@ bool CirMgr::parseSymbol(ifstream& cirin) {
                 }
                 CirRiGate* ri = _riList[portId];
                 CirRoGate* ro = _roList[portId];
-                if (ri->getName()) {
+                if (getName(ri->getGid())) {
                     errMsg = "l";
                     errInt = portId;
                     return parseError(REDEF_SYMBOLIC_NAME);
                 }
-                if (ro->getName()) {
+                if (getName(ro->getGid())) {
                     errMsg = "l";
                     errInt = portId;
                     return parseError(REDEF_SYMBOLIC_NAME);
                 }
-                char* n = new char[strlen(str) + 1];
-                strcpy(n, str);
-                ri->setName(n);
-                ro->setName(n);
+                for (int j = 0; j < 2; ++j) {
+                    char* n = new char[strlen(str) + 1];
+                    strcpy(n, str);
+                    setName(j ? ro->getGid() : ri->getGid(), n);
+                }
             } else {  // if (type == 'o')
                 assert(type == 'o');
                 if (portId >= _numDecl[PO]) {
@@ -528,14 +556,14 @@ bool CirMgr::parseSymbol(ifstream& cirin) {
                     return parseError(NUM_TOO_BIG);
                 }
                 CirPoGate* po = _poList[portId];
-                if (po->getName()) {
+                if (getName(po->getGid())) {
                     errMsg = "o";
                     errInt = portId;
                     return parseError(REDEF_SYMBOLIC_NAME);
                 }
                 char* n = new char[strlen(str) + 1];
                 strcpy(n, str);
-                po->setName(n);
+                setName(po->getGid(), n);
             }
         } else if (type == 'c') return true;
         else if (type == ' ') return parseError(EXTRA_SPACE);
@@ -600,18 +628,19 @@ CirMgr::checkGate(unsigned& litId, ParsePorts type, const string& err) {
     }
     switch (type) {
         case PI:
-            gate = new CirPiGate(litId / 2, lineNo + 1);
+            gate = new CirPiGate(litId / 2);
             break;
         case AIG:
-            gate = new CirAigGate(litId / 2, lineNo + 1);
+            gate = new CirAigGate(litId / 2);
             break;
         case LATCH:
-            gate = new CirRoGate(litId / 2, lineNo + 1);
+            gate = new CirRoGate(litId / 2);
             break;
         default:
             cerr << "Error: Unknown gate type (" << type << ")!!\n";
             exit(-1);
     }
+    setLineNo(litId / 2, lineNo + 1);
     return gate;
 }
 
@@ -639,75 +668,171 @@ void CirMgr::genConnections() {
     }
 }
 
-void CirPoGate::genConnections() {
-    // _in0 = cirMgr->checkConnectedGate(_in0());
-    // cout << "_in0 = " << _in0 << endl;
-    // cirMgr->getFanouts(_in0.gateId()).push_back(this);
-}
-
-void CirRiGate::genConnections() {
-    _in0 = cirMgr->checkConnectedGate(_in0());
-    // cirMgr->getFanouts(_in0.gateId()).push_back(this);
-}
-
-void CirAigGate::genConnections() {
-    // _in0 = cirMgr->checkConnectedGate(_in0());
-    // cirMgr->getFanouts(_in0.gateId()).push_back(this);
-    // _in1 = cirMgr->checkConnectedGate(_in1());
-    // cirMgr->getFanouts(_in1.gateId()).push_back(this);
+// Only an RI may still hold a literal to be resolved
+void CirGate::genConnections() {
+    if (_type == RI_GATE) _in0 = cirMgr->checkConnectedGate(_in0());
 }
 
 void CirMgr::genDfsList() {
     clearList(_dfsList);
+    if (_flatAig) {
+        delete _flatAig;
+        _flatAig = 0;
+    }
+    _cutSim.reset();
     CirGate::setGlobalRef();
     for (unsigned i = 0, n = getNumPOs(); i < n; ++i)
         getPo(i)->genDfsList(_dfsList);
 
     for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i)
         getRi(i)->genDfsList(_dfsList);
+
+    _dfsIdx.assign(getNumTots(), UINT_MAX);
+    for (unsigned i = 0, n = _dfsList.size(); i < n; ++i)
+        _dfsIdx[_dfsList[i]->getGid()] = i;
+    genFanoutInfo();
+    _levelStart.clear();
+    unsetFlag(DFS_STALE);
 }
 
-void CirPiGate::genDfsList(GateList& gateList) {
-    setToGlobalRef();
-    gateList.push_back(this);
+/**
+ * @brief Marks the DFS list as out of date.
+ *
+ * For the edits that addDfsGate() cannot follow, e.g. a fanin of an
+ * existing gate is changed. The list is rebuilt by the next
+ * updateDfsList(), which getFlatAig() and the simulation commands call.
+ */
+void CirMgr::invalidateDfsList() {
+    setFlag(DFS_STALE);
+    _levelStart.clear();
+    if (_flatAig) {
+        delete _flatAig;
+        _flatAig = 0;
+    }
+    _cutSim.reset();
 }
 
-void CirRoGate::genDfsList(GateList& gateList) {
-    setToGlobalRef();
-    gateList.push_back(this);
+/**
+ * @brief Appends a new gate to the DFS list and the fanout lists.
+ *
+ * The fanins of g that are not in the list yet (e.g. dangling gates
+ * returned by the strash table) are appended first, so the list stays
+ * topologically sorted without a new traversal. Does nothing if g is
+ * already in the list.
+ *
+ * @param g A gate whose fanins are all defined.
+ */
+void CirMgr::addDfsGate(CirGate* g) {
+    const unsigned gid = g->getGid();
+    if (gid < _dfsIdx.size() && _dfsIdx[gid] != UINT_MAX) return;
+    if (isFlag(DFS_STALE)) return;  // rebuilt from scratch later anyway
+    if (_dfsIdx.size() < getNumTots()) {
+        _dfsIdx.resize(getNumTots(), UINT_MAX);
+        _fanoutInfo.resize(getNumTots());
+    }
+    if (g->isAig()) {  // an RO is a source, like in genDfsList()
+        addDfsGate(g->getIn0Gate());
+        addDfsGate(g->getIn1Gate());
+    }
+    _dfsIdx[gid] = _dfsList.size();
+    _dfsList.push_back(g);
+    // the gates that existed at genFanoutInfo() already have their fanouts
+    if (gid >= _nFanoutGids) addFanouts(g);
+    _levelStart.clear();
+    if (_flatAig) {
+        delete _flatAig;
+        _flatAig = 0;
+    }
 }
 
-void CirPoGate::genDfsList(GateList& gateList) {
-    setToGlobalRef();
-    CirGate* g = _in0.gate();
-    if (!g->isGlobalRef())
-        g->genDfsList(gateList);
-    gateList.push_back(this);
+/**
+ * @brief Computes the levels, the reverse levels and the level buckets.
+ *
+ * One forward and one backward sweep over the DFS list; does nothing if
+ * the levels are still valid. The buckets keep the DFS order within a
+ * level, so walking them level by level is also a topological order.
+ */
+void CirMgr::levelize() {
+    updateDfsList();
+    if (isLevelized()) return;
+    _levels.assign(getNumTots(), 0);
+    _revLevels.assign(getNumTots(), 0);
+    unsigned nLevels = 1;
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        const CirGate* g = _dfsList[i];
+        unsigned& l      = _levels[g->getGid()];
+        if (g->isAig())
+            l = 1 + max(_levels[g->getIn0Gate()->getGid()],
+                        _levels[g->getIn1Gate()->getGid()]);
+        else if (g->isPo() || g->getType() == RI_GATE)
+            l = _levels[g->getIn0Gate()->getGid()];
+        if (l >= nLevels) nLevels = l + 1;
+    }
+    for (size_t i = _dfsList.size(); i-- > 0;) {
+        const CirGate* g = _dfsList[i];
+        if (!g->isAig() && !g->isPo() && g->getType() != RI_GATE) continue;
+        const unsigned r = _revLevels[g->getGid()] + (g->isAig() ? 1 : 0);
+        for (unsigned j = 0, m = g->getNumFanins(); j < m; ++j) {
+            unsigned& rf = _revLevels[(j ? g->getIn1Gate() : g->getIn0Gate())->getGid()];
+            if (rf < r) rf = r;
+        }
+    }
+
+    // Counting sort of the DFS list by level
+    _levelStart.assign(nLevels + 1, 0);
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        const CirGate* g = _dfsList[i];
+        if (!g->isPo() && g->getType() != RI_GATE)
+            ++_levelStart[_levels[g->getGid()] + 1];
+    }
+    for (unsigned l = 0; l < nLevels; ++l) _levelStart[l + 1] += _levelStart[l];
+    _levelGids.resize(_levelStart[nLevels]);
+    IdList pos(_levelStart.begin(), _levelStart.end() - 1);
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        const CirGate* g = _dfsList[i];
+        if (!g->isPo() && g->getType() != RI_GATE)
+            _levelGids[pos[_levels[g->getGid()]]++] = g->getGid();
+    }
 }
 
-void CirRiGate::genDfsList(GateList& gateList) {
-    setToGlobalRef();
-    CirGate* g = _in0.gate();
-    if (!g->isGlobalRef())
-        g->genDfsList(gateList);
-    gateList.push_back(this);
+void CirMgr::genFanoutInfo() {
+    clearList(_fanoutInfo);
+    _fanoutInfo.resize(getNumTots());
+    _nFanoutGids = getNumTots();
+    for (unsigned i = 0, n = getNumTots(); i < n; ++i)
+        if (_totGateList[i] != 0) addFanouts(_totGateList[i]);
 }
 
-void CirAigGate::genDfsList(GateList& gateList) {
-    setToGlobalRef();
-    CirGate* g = _in0.gate();
-    // cout << g->getGid()<<endl;
-    if (!g->isGlobalRef())
-        g->genDfsList(gateList);
-    g = _in1.gate();
-    // cout << g->getGid()<<endl;
-    if (!g->isGlobalRef())
-        g->genDfsList(gateList);
-    gateList.push_back(this);
+void CirMgr::addFanouts(CirGate* g) {
+    for (unsigned j = 0, m = g->getNumFanins(); j < m; ++j) {
+        CirGate* f = j ? g->getIn1Gate() : g->getIn0Gate();
+        if (f != 0) _fanoutInfo[f->getGid()].push_back(g);
+    }
+}
+
+const CirFlatAig& CirMgr::getFlatAig() {
+    levelize();
+    if (!_flatAig) {
+        _flatAig = new CirFlatAig;
+        _flatAig->build(this);
+    }
+    return *_flatAig;
 }
 
-void CirConstGate::genDfsList(GateList& gateList) {
+// PI, RO and const 0 are sources; an UNDEF gate is never listed
+void CirGate::genDfsList(GateList& gateList) {
     setToGlobalRef();
+    if (_type == UNDEF_GATE) return;
+    if (_type == AIG_GATE || _type == PO_GATE || _type == RI_GATE) {
+        CirGate* g = _in0.gate();
+        if (!g->isGlobalRef())
+            g->genDfsList(gateList);
+        if (_type == AIG_GATE) {
+            g = _in1.gate();
+            if (!g->isGlobalRef())
+                g->genDfsList(gateList);
+        }
+    }
     gateList.push_back(this);
 }
 
@@ -833,6 +958,80 @@ void CirMgr::printFloatGates() const {
     }
 }
 
+/*********************
+Circuit Levels
+==================
+  Depth         12
+  AIG          130
+  Max width     32 (level 3)
+  Avg width  10.83
+
+  Level      #AIG
+      1-2      40  ##########
+  ...
+*********************/
+// One row per level, or per range of levels if there are more than
+// maxRows of them; the bars are scaled to the widest row
+static void printLevelHistogram(const IdList& counts, unsigned first,
+                                const string& title) {
+    const unsigned maxRows = 20, maxBar = 40;
+    const unsigned n       = counts.size() - first;
+    if (n == 0) return;
+    const unsigned step = (n + maxRows - 1) / maxRows;
+    IdList rows;
+    for (unsigned l = first; l < counts.size(); l += step) {
+        unsigned c = 0;
+        for (unsigned k = l; k < l + step && k < counts.size(); ++k) c += counts[k];
+        rows.push_back(c);
+    }
+    const unsigned maxRow = *max_element(rows.begin(), rows.end());
+    cout << endl
+         << "  " << setw(11) << left << "Level" << title << endl;
+    for (unsigned i = 0; i < rows.size(); ++i) {
+        const unsigned lo = first + i * step;
+        const unsigned hi = min(lo + step, unsigned(counts.size())) - 1;
+        string range      = to_string(lo);
+        if (hi != lo) range += "-" + to_string(hi);
+        cout << "  " << setw(9) << right << range << setw(8) << rows[i] << "  "
+             << string(maxRow ? (size_t(rows[i]) * maxBar + maxRow - 1) / maxRow : 0, '#')
+             << endl;
+    }
+    cout << left;
+}
+
+// CIRPrint -Levels: the depth, the width of each level and the levels of
+// the POs/RIs
+void CirMgr::printLevels() {
+    levelize();
+    const unsigned depth = getNumLevels() - 1;
+    IdList widths(getNumLevels(), 0), outputs(getNumLevels(), 0);
+    unsigned nAigs = 0, maxLevel = 0;
+    for (unsigned l = 1; l <= depth; ++l) {
+        widths[l] = getLevelSize(l);
+        nAigs += widths[l];
+        if (widths[l] > widths[maxLevel]) maxLevel = l;
+    }
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i)
+        ++outputs[getLevel(getPo(i)->getGid())];
+    for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i)
+        ++outputs[getLevel(getRi(i)->getGid())];
+
+    cout << endl;
+    cout << "Circuit Levels" << endl
+         << "==================" << endl;
+    cout << "  " << setw(10) << left << "Depth" << setw(7) << right << depth << endl;
+    cout << "  " << setw(10) << left << "AIG" << setw(7) << right << nAigs << endl;
+    if (depth) {
+        cout << "  " << setw(10) << left << "Max width" << setw(7) << right
+             << widths[maxLevel] << " (level " << maxLevel << ")" << endl;
+        cout << "  " << setw(10) << left << "Avg width" << setw(7) << right
+             << fixed << setprecision(2) << double(nAigs) / depth << endl;
+        printLevelHistogram(widths, 1, "#AIG");
+    }
+    printLevelHistogram(outputs, 0, "#PO/RI");
+    cout.unsetf(ios::floatfield);
+}
+
 void CirMgr::printFECPairs() const {
     struct ArrIdx {
         unsigned _litId;
@@ -841,160 +1040,19 @@ void CirMgr::printFECPairs() const {
         bool operator<(const ArrIdx& i) const { return (_litId < i._litId); }
     };
     vector<ArrIdx> fecOrder;
-    for (size_t i = 0, n = _fecGrps.size(); i < n; ++i)
-        fecOrder.push_back(ArrIdx((_fecGrps[i])->operator[](0), i));
+    for (size_t i = 0, n = getNumFECGrps(); i < n; ++i)
+        fecOrder.push_back(ArrIdx(getFECLit(i, 0), i));
     ::sort(fecOrder.begin(), fecOrder.end());
     for (size_t i = 0, n = fecOrder.size(); i < n; ++i) {
         size_t idx = fecOrder[i]._idx;
-        IdList* ll = _fecGrps[idx];
         cout << "[" << i << "]";
-        for (size_t j = 0, m = ll->size(); j < m; ++j)
-            cout << " " << litId2GateV((*ll)[j]);
+        for (size_t j = 0, m = getFECGrpSize(idx); j < m; ++j)
+            cout << " " << litId2GateV(getFECLit(idx, j));
         cout << endl;
     }
 }
 
-void CirMgr::writeAag(ostream& outfile) const {
-    size_t nAig = 0;
-    for (size_t i = 0, n = _dfsList.size(); i < n; ++i)
-        if (_dfsList[i]->isAig()) ++nAig;
-    outfile << "aag " << _numDecl[VARS] + nAig << " " << _numDecl[PI] << " "
-            << _numDecl[LATCH] << " " << _numDecl[PO] << " "
-            << nAig << endl;
-    for (size_t i = 0, n = _numDecl[PI]; i < n; ++i)
-        outfile << (getPi(i)->getGid() * 2) << endl;
-
-    // Update Latch for sequential circuit.
-    for (size_t i = 0, n = _numDecl[LATCH]; i < n; ++i)
-        outfile << getRo(i)->getGid() * 2 << " " << getRi(i)->getIn0().litId() << endl;
-
-    for (size_t i = 0, n = _numDecl[PO]; i < n; ++i)
-        outfile << getPo(i)->getIn0().litId() << endl;
-    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
-        CirGate* g = _dfsList[i];
-        if (!g->isAig()) continue;
-        outfile << g->getGid() * 2 << " " << g->getIn0().litId() << " "
-                << g->getIn1().litId() << endl;
-    }
-    for (size_t i = 0, n = _numDecl[PI]; i < n; ++i)
-        if (getPi(i)->getName())
-            outfile << "i" << i << " " << getPi(i)->getName() << endl;
-    for (size_t i = 0, n = _numDecl[PO]; i < n; ++i)
-        if (getPo(i)->getName())
-            outfile << "o" << i << " " << getPo(i)->getName() << endl;
-    outfile << "c" << endl;
-    outfile << "AAG output by Chung-Yang (Ric) Huang" << endl;
-}
-
-void CirMgr::writeBlif(const string& fileName) const {
-    //     IDMap aigIdMap;
-    //     cirMgr->reorderGateId(aigIdMap);
-    //     abcMgr->cirToAig(aigIdMap);
-    //     abcMgr->writeBlif(fileName);
-    yosysMgr->writeBlif(fileName);
-}
-
-void CirMgr::writeGate(ostream& outfile, CirGate* g) const {
-    GateList faninCone;
-    CirGate::setGlobalRef();
-    g->genDfsList(faninCone);
-
-    size_t nAig = 0, npi = 0;
-    unsigned maxId = 0;
-    for (size_t i = 0, n = faninCone.size(); i < n; ++i) {
-        if (faninCone[i]->isAig()) ++nAig;
-        else if (faninCone[i]->isPi()) ++npi;
-        if (faninCone[i]->getGid() > maxId) maxId = faninCone[i]->getGid();
-    }
-    outfile << "aag " << maxId << " " << npi << " 0 1 " << nAig << endl;
-    // for (size_t i = 0, n = _numDecl[PI]; i < n; ++i)
-    for (size_t i = 0, n = cirMgr->getNumPIs(); i < n; ++i)
-        if (getPi(i)->isGlobalRef())
-            outfile << (getPi(i)->getGid() * 2) << endl;
-    outfile << g->getGid() * 2 << endl;
-    for (size_t i = 0, n = faninCone.size(); i < n; ++i) {
-        CirGate* f = faninCone[i];
-        if (!f->isAig()) continue;
-        outfile << f->getGid() * 2 << " " << f->getIn0().litId() << " "
-                << f->getIn1().litId() << endl;
-    }
-    for (size_t i = 0, n = cirMgr->getNumPIs(), j = 0; i < n; ++i)
-        if (getPi(i)->isGlobalRef() && getPi(i)->getName())
-            outfile << "i" << j++ << " " << getPi(i)->getName() << endl;
-    outfile << "o0 " << g->getGid() << endl;
-    outfile << "c" << endl;
-    outfile << "Write gate (" << g->getGid()
-            << ") by Chung-Yang (Ric) Huang" << endl;
-}
-
 const bool CirMgr::readBlif(const string& fileName) const {
     yosysMgr->init();
     yosysMgr->readBlif(fileName);
 }
-/**********************************************************/
-/*   class CirMgr member functions for hidden commands    */
-/**********************************************************/
-// After this command, cm1 and cm2 will be deleted!!
-// bool
-// CirMgr::createMiter(CirMgr *cm1, CirMgr *cm2)
-// {
-//    ofstream outfile("/tmp/miter.aag");
-//    size_t npi   = cm1->_numDecl[PI];
-//    size_t npo   = cm1->_numDecl[PO];
-//    size_t nVarO = cm1->_numDecl[VARS] + cm2->_numDecl[VARS] + 1;
-//    size_t nVar  = nVarO + 3*npo;
-//    size_t nAig1 = 0, nAig2 = 0;
-//    for (size_t i = 0, n = cm1->_dfsList.size(); i < n; ++i)
-//       if (cm1->_dfsList[i]->isAig()) ++nAig1;
-//    for (size_t i = 0, n = cm2->_dfsList.size(); i < n; ++i)
-//       if (cm2->_dfsList[i]->isAig()) ++nAig2;
-//    size_t nAig = nAig1 + nAig2 + 3*npo;
-//    size_t vOffset = cm1->_numDecl[VARS] + 1;
-//    outfile << "aag " << nVar << " " << npi << " 0 " << npo << " "
-//            << nAig << endl;
-//    for (size_t i = 0; i < npi; ++i)
-//       outfile << (cm1->getPi(i)->getGid()*2) << endl;
-//    for (size_t i = 0; i < npo; ++i)
-//       outfile << (nVarO+3+i*3)*2 << endl;
-//    for (size_t i = 0, n = cm1->_dfsList.size(); i < n; ++i) {
-//       CirGate *g = cm1->_dfsList[i];
-//       if (!g->isAig()) continue;
-//       outfile << g->getGid()*2 << " " << g->getIn0().litId() << " "
-//               << g->getIn1().litId() << endl;
-//    }
-//    for (size_t i = 0, n = cm2->_dfsList.size(); i < n; ++i) {
-//       CirGate *g = cm2->_dfsList[i];
-//       if (!g->isAig()) continue;
-//       outfile << (g->getGid() + vOffset)*2;
-//       if (g->getIn0Gate()->isAig())
-//          outfile << " " << (g->getIn0().litId() + vOffset*2) << " ";
-//       else
-//          outfile << " " << g->getIn0().litId() << " ";
-//       if (g->getIn1Gate()->isAig())
-//          outfile << (g->getIn1().litId() + vOffset*2) << endl;
-//       else
-//          outfile << g->getIn1().litId() << endl;
-//    }
-//    for (size_t i = 0, j = nVarO + 1; i < npo; ++i, j += 3) {
-//       unsigned po1 = cm1->getPo(i)->getIn0().litId();
-//       unsigned po2 = cm2->getPo(i)->getIn0Gate()->isAig()?
-//                      cm2->getPo(i)->getIn0().litId() + vOffset * 2:
-//                      cm2->getPo(i)->getIn0().litId();
-//       outfile << j*2 << " " << po1 << " " << po2 << endl;
-//       outfile << (j+1)*2 << " " << (po1^0x1) << " " << (po2^0x1) << endl;
-//       outfile << (j+2)*2 << " " << j*2+1 << " " << (j+1)*2+1 << endl;
-//    }
-//    for (size_t i = 0; i < npi; ++i)
-//       if (cm1->getPi(i)->getName())
-//          outfile << "i" << i << " " << cm1->getPi(i)->getName() << endl;
-//    for (size_t i = 0; i < npo; ++i)
-//       if (cm1->getPo(i)->getName())
-//          outfile << "o" << i << " " << cm1->getPo(i)->getName() << endl;
-//    outfile << "c" << endl;
-//    outfile << "Miter output by Chung-Yang (Ric) Huang" << endl;
-
-//    outfile.close();
-
-//    deleteCircuit();
-//    return readCircuit("/tmp/miter.aag");
-// }
@@ -9,6 +9,8 @@
 #ifndef CIR_MGR_H
 #define CIR_MGR_H
 
+#include <cassert>
+#include <climits>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -21,13 +23,19 @@ using namespace std;
 #include "base/abc/abc.h"
 #include "cirCut.h"
 #include "cirDef.h"
+#include "cirGate.h"
 #include "fileType.h"
 
 extern CirMgr* cirMgr;
 
 class AbcMgr;
+class CirFlatAig;
+class CirEventSim;
+class SolverV;
+struct CirAigReader;
+class CirWriteBuf;
 class CirMgr {
-    enum CirMgrFlag { NO_FEC = 0x1 };
+    enum CirMgrFlag { NO_FEC = 0x1, DFS_STALE = 0x2 };
     enum ParsePorts { VARS = 0,
                       PI,
                       LATCH,
@@ -36,7 +44,7 @@ class CirMgr {
                       TOT_PARSE_PORTS };
 
 public:
-    CirMgr() : _flag(0), _piList(0), _poList(0), _totGateList(0), _fanoutInfo(0), _simLog(0) {}
+    CirMgr() : _const1(0), _flag(0), _piList(0), _poList(0), _totGateList(0), _nFanoutGids(0), _fecTime(0), _fecRounds(0), _simLog(0), _simProfile(false), _simEvent(false), _simTime(0), _eventSim(0), _flatAig(0) {}
     ~CirMgr() { deleteCircuit(); }
 
     // Abc Interface
@@ -70,7 +78,56 @@ public:
     CirRiGate* getRi(unsigned i) const { return _riList[i]; }
     CirRoGate* getRo(unsigned i) const { return _roList[i]; }
     CirAigGate* getAig(unsigned i) const { return _aigList[i]; }
-    GateList& getFanouts(unsigned i) const { return _fanoutInfo[i]; }
+    const GateList& getFanouts(unsigned i) const { return _fanoutInfo[i]; }
+    // Topological order; call updateDfsList() first if the netlist is edited
+    const GateList& getDfsList() const { return _dfsList; }
+    // Position in the DFS list, or UINT_MAX if the gate is not in it
+    unsigned getDfsIdx(unsigned gid) const {
+        return gid < _dfsIdx.size() ? _dfsIdx[gid] : UINT_MAX;
+    }
+    // Levels of the gates in the DFS list; valid after levelize() until the
+    // DFS list changes. Level 0 holds const, PIs and ROs; a PO or an RI
+    // has the level of its fanin. The reverse level is the # of AND gates
+    // on the longest path to a PO or RI.
+    void levelize();
+    bool isLevelized() const { return !_levelStart.empty(); }
+    unsigned getNumLevels() const {
+        return _levelStart.empty() ? 0 : _levelStart.size() - 1;
+    }
+    unsigned getLevel(unsigned gid) const { return _levels[gid]; }
+    unsigned getRevLevel(unsigned gid) const { return _revLevels[gid]; }
+    unsigned getLevelSize(unsigned l) const {
+        return _levelStart[l + 1] - _levelStart[l];
+    }
+    // The j-th gate (in DFS order) of level l; POs and RIs are excluded
+    CirGate* getLevelGate(unsigned l, unsigned j) const {
+        return _totGateList[_levelGids[_levelStart[l] + j]];
+    }
+    // Flat copy of the AIG; rebuilt on demand after the DFS list changes
+    const CirFlatAig& getFlatAig();
+
+    // Side tables of the gates (see CirGate), indexed by the gate ID
+    // The names are owned by the table; setName() takes the ownership
+    char* getName(unsigned gid) const {
+        NameMap::const_iterator it = _names.find(gid);
+        return (it == _names.end()) ? 0 : it->second;
+    }
+    void setName(unsigned gid, char* name);
+    void deleteName(unsigned gid);
+    // The line in the AAG file; 0 for the gates from the other readers
+    unsigned getLineNo(unsigned gid) const {
+        return gid < _lineNos.size() ? _lineNos[gid] : 0;
+    }
+    // Valid after a simulation; the table grows to getNumTots() on
+    // setPValue(), and the gates beyond it read as all 0
+    const CirPValue& getPValue(unsigned gid) const {
+        static const CirPValue zero;
+        return (gid < _pValues.size()) ? _pValues[gid] : zero;
+    }
+    void setPValue(unsigned gid, const CirPValue& v) const {
+        if (gid >= _pValues.size()) _pValues.resize(getNumTots());
+        _pValues[gid] = v;
+    }
 
     string getFileName() const { return fileName; }
 
@@ -79,6 +136,11 @@ public:
     void deleteCircuit();
     void genConnections();
     void genDfsList();
+    void updateDfsList() {
+        if (isFlag(DFS_STALE)) genDfsList();
+    }
+    void invalidateDfsList();
+    void addDfsGate(CirGate*);
     void updateUndefList();
     void checkFloatList();
     void checkUnusedList();
@@ -90,20 +152,49 @@ public:
     bool checkAigOptimize(CirGate*, const CirGateV&, const CirGateV&, CirGateV&) const;
     void deleteAigGate(CirGate*);
     void deleteUndefGate(CirGate*);
+    void rewrite();
+    static CirGateV getEqGateV(CirGateV);
 
     // Member functions about simulation
-    void randomSim();
+    void randomSim(unsigned nThreads = 1);
     void fileSim(ifstream&);
+    bool seqSim(unsigned nCycles, int monitor = -1, unsigned nThreads = 1);
     void setSimLog(ofstream* logFile) { _simLog = logFile; }
+    void setSimProfile(bool p) { _simProfile = p; }
+    void setSimEvent(bool e) { _simEvent = e; }
     void ReadSimVal();
-    void cutSim(CirGate* rootGate, CirCut* cut);
+    // Exhaustive truth tables over cuts; see CirCutSim
+    const size_t* cutSim(const CirGate* root, const unsigned* leaves,
+                         unsigned nLeaves) {
+        return _cutSim.simulate(root, leaves, nLeaves);
+    }
+    size_t cutSim(const CirGate* root, const CirCut& cut) {
+        const size_t* t = cutSim(root, cut.getLeaves(), cut.getNumLeaves());
+        assert(t != 0);
+        return *t;
+    }
 
     // Member functions about fraig
     void strash();
-    IdList* getFECGrps(size_t i) const { return _fecGrps[i]; }
+    size_t getNumFECGrps() const {
+        return _fecGrpStart.empty() ? 0 : _fecGrpStart.size() - 1;
+    }
+    size_t getFECGrpSize(size_t i) const {
+        return _fecGrpStart[i + 1] - _fecGrpStart[i];
+    }
+    unsigned getFECLit(size_t i, size_t j) const {
+        return _fecLits[_fecGrpStart[i] + j];
+    }
     void printFEC() const;
     void fraig();
 
+    // Member functions about latch correspondence
+    void latchCorr(unsigned depth = 1, unsigned nCycles = 64);
+
+    // Member functions about ternary simulation
+    bool ternarySim(unsigned nCycles, const string& init, bool randPIs);
+    bool getConstLatches(IdList& consts, unsigned maxCycles = 1024);
+
     // Member functions about circuit reporting
     // Member functins about circuit reporting
     void printSummary() const;
@@ -112,13 +203,18 @@ public:
     void printPOs() const;
     void printFloatGates() const;
     void printFECPairs() const;
-    void writeAag(ostream&) const;
-    void writeBlif(const string&) const;
-    void writeGate(ostream&, CirGate*) const;
+    void printLevels();
+    bool writeAag(ostream&) const;
+    bool writeBlif(const string&) const;
+    bool writeGate(ostream&, CirGate*) const;
+    // Buffered, optionally gzipped; reports the size and the throughput
+    bool writeFile(const string&, FileType, bool gzip = false, CirGate* = 0) const;
 
-    // Member functions about flags
-    // for hidden command
-    bool createMiter(CirMgr*, CirMgr*);
+    // Member functions about equivalence checking
+    bool createMiter(CirMgr*, CirMgr*, bool pairLatches = false);
+    // nCycles: BMC from reset on the outputs that need the latches of a
+    // product machine; 0 if the latches are paired (no BMC)
+    bool checkMiter(unsigned nCycles = 10);
     static CirGate* _const0;
     // MODIFICATION FOR SOCV HOMEWORK
     void initCir(Gia_Man_t* pGia, const FileType& type);
@@ -129,17 +225,21 @@ public:
     // void buildNtkFdd();
     void addTotGate(CirGate* gate) { _totGateList.push_back(gate); };
     const bool readCirFromAbc(string, FileType);
+    bool readAig(const string&);
+    bool writeAig(ostream&) const;
     const bool readBlif(const string&) const;
     const bool setBddOrder(const bool&);
     // CirGate* createGate(const GateType& type);
-    CirGate* createNotGate(CirGate*);
-    CirGate* createAndGate(CirGate*, CirGate*);
-    CirGate* createOrGate(CirGate*, CirGate*);
-    CirGate* createXorGate(CirGate*, CirGate*);
+    // Structurally hashed; may return an existing gate or a constant
+    CirGateV createNotGate(const CirGateV&);
+    CirGateV createAndGate(const CirGateV&, const CirGateV&);
+    CirGateV createOrGate(const CirGateV&, const CirGateV&);
+    CirGateV createXorGate(const CirGateV&, const CirGateV&);
+    void resetStrash() { _strashHash.reset(); }
     CirGate* _const1;
 
     // Member functions for creating gate from the Gia object
-    void createInput(const int& idx, const int& gateId);
+    void createInput(const int& idx, const int& gateId, string piName = "");
     void createOutput(const int& idx, const int& gateId, const int& in0Id, const int& inv, string poName);
     void createRi(const int& idx, const int& gateId, const int& in0Id, const int& inv);
     int createRo(const int& idx, const int& gateId, const FileType& fileType);
@@ -166,12 +266,39 @@ private:
     IdList _floatList;   // gates with fanin(s) undefined
     IdList _unusedList;  // gates defined but not used
     GateArray _totGateList;
+    // The fanin cones of the POs and RIs, plus the gates created or added by
+    // addDfsGate() afterwards, in topological order
     GateList _dfsList;
-    GateList* _fanoutInfo;
-    vector<IdList*> _fecGrps;  // store litId; FECHash<GatePValue, IdList*>
+    IdList _dfsIdx;                // gate ID -> position in _dfsList
+    vector<GateList> _fanoutInfo;  // gate ID -> fanouts
+    unsigned _nFanoutGids;         // gate IDs covered by genFanoutInfo()
+    // Level buckets: level l is [_levelStart[l], _levelStart[l+1]) of
+    // _levelGids; empty if not levelized
+    IdList _levels;                // gate ID -> level
+    IdList _revLevels;             // gate ID -> reverse level
+    IdList _levelGids;
+    IdList _levelStart;
+    // FEC groups (litIds): group i is [_fecGrpStart[i], _fecGrpStart[i+1])
+    // of _fecLits; _fecGrpStart is empty before the first refinement
+    IdList _fecLits;
+    IdList _fecGrpStart;
+    vector<pair<size_t, unsigned> > _fecKeys;  // scratch of checkFEC()
+    double _fecTime;                           // seconds in refineFEC()
+    size_t _fecRounds;
     SimVector _fecVector;
     ofstream* _simLog;
+    bool _simProfile;        // report patterns/sec after simulation
+    bool _simEvent;          // event-driven simulation in fileSim()
+    double _simTime;         // seconds spent in the simulation kernel
+    CirEventSim* _eventSim;  // only during fileSim() with _simEvent
     string fileName;
+    StrashHash _strashHash;  // for create*Gate(); built on first use
+    CirFlatAig* _flatAig;    // built on first use by getFlatAig()
+    CirCutSim _cutSim;       // reset whenever _flatAig is
+    // Side tables of the gates
+    NameMap _names;                      // gate ID -> name (named gates only)
+    IdList _lineNos;                     // gate ID -> line (AAG files only)
+    mutable vector<CirPValue> _pValues;  // gate ID -> simulation value
 
     // private member functions for circuit parsing
     bool parseHeader(ifstream&);
@@ -182,32 +309,70 @@ private:
     bool parseSymbol(ifstream&);
     bool parseComment(ifstream&);
     bool checkId(unsigned&, const string&);
+    int readAigBody(CirAigReader&);
     CirGate* checkGate(unsigned&, ParsePorts, const string&);
+    void setLineNo(unsigned gid, unsigned l) {
+        if (gid >= _lineNos.size()) _lineNos.resize(gid + 1, 0);
+        _lineNos[gid] = l;
+    }
+    void genFanoutInfo();
+    void addFanouts(CirGate*);
 
     // private member functions for circuit optimization
     CirGateV constSimplify(CirGate*, const CirGateV&, const CirGateV&) const;
+    void initStrash();
+    int getConstValue(const CirGateV&) const;
 
     // private member functions about simulation
-    void setRandPPattern() const;
     void setPPattern(SimPattern const patterns) const;
     unsigned gatherPatterns(ifstream&, SimPattern, size_t);
     void pSim1Pattern() const;
+    void eventSim1Pattern();
     void outputSimLog(size_t nPatterns = 64);
+    void reportSimProfile(size_t nSims, double start) const;
+    void reportFECTime() const;
+    void parallelRandomSim(unsigned, size_t, size_t&, size_t&);
+    void setFlatPValues(const CirFlatAig&, const vector<size_t>&, size_t,
+                        size_t) const;
 
     // private member functions about FRAIG
     bool simAndCheckFEC();
+    bool refineFEC();
     bool initFEC();
     bool checkFEC();
-    bool checkFECRecur(const IdList&, vector<IdList*>&);
     void finalizeFEC();
     void simplifyFECGrps();
     void clearFECGrps();
-    void initProofModel(SatSolver&, const GateList&);
-    bool satCheckConst(SatSolver&, CirGate*, bool, SimPattern);
-    bool satCheckFEC(SatSolver&, CirGate*, CirGate*, bool, SimPattern);
-    void getSatAssignment(SatSolver&, SimPattern) const;
+    void computeFECReps(const IdList&, IdList&) const;
+    int satCheckFEC(SolverV&, const vector<int>&, CirGate*, CirGate*, bool,
+                    SimPattern, unsigned);
+    int cutCheckFEC(CirGate*, CirGate*, bool, SimPattern, unsigned);
+    void getSatAssignment(SolverV&, const vector<int>&, SimPattern,
+                          unsigned) const;
     void simplifyByEQ();
+    void updateAfterRemoval();
     void updateFECbySatPattern(SimPattern);
+
+    // private member functions about latch correspondence
+    void removeMergedLatches();
+
+    // private member functions about the miter
+    void miterBmc(const CirFlatAig&, const IdList&, unsigned, IdList&, IdList&,
+                  vector<string>&) const;
+
+    // private member functions about the writers
+    void writeAag(CirWriteBuf&) const;
+    void writeAig(CirWriteBuf&) const;
+    void writeGate(CirWriteBuf&, CirGate*) const;
+    void writeBlif(CirWriteBuf&, const string&) const;
+
+    // private member functions about rewriting
+    bool rwrGetInputs(const CirCut&, const IdList&, CirGateV*) const;
+    unsigned rwrDeref(CirGate*, IdList&) const;
+    unsigned rwrRef(CirGate*, IdList&) const;
+    bool rwrBuild(const CirRwrStruct&, unsigned, const CirRwrLib&,
+                  const CirGateV*, const CirGate*, IdList&, bool, unsigned&,
+                  CirGateV&);
 };
 
 #endif  // CIR_MGR_H
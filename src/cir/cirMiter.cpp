@@ -0,0 +1,444 @@
+/****************************************************************************
+  FileName     [ cirMiter.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the miter construction and the equivalence check ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <cassert>
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+#include "SolverV.h"
+#include "cirDef.h"
+#include "cirFlat.h"
+#include "cirGate.h"
+#include "cirMgr.h"
+#include "util.h"
+
+using namespace std;
+
+// Conflict limit of the final SAT call on each miter output
+#define CIR_MITER_EFFORT 100000
+// # of failed outputs reported one by one
+#define CIR_MITER_MAX_REPORTS 10
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// The readers name an unnamed PO by its gate ID, which means nothing in
+// the other circuit
+static bool isDesignName(const char* s) {
+    if (s == 0 || *s == '\0') return false;
+    for (; *s; ++s)
+        if (!isdigit(*s)) return true;
+    return false;
+}
+
+static char* copyName(const string& s) {
+    char* n = new char[s.size() + 1];
+    strcpy(n, s.c_str());
+    return n;
+}
+
+/**
+ * Pairs the items of two lists: by name if every item of both lists has a
+ * unique design name, otherwise by position if the lists have the same
+ * size. match[j] is the index in n1 of item j of n2, or UINT_MAX.
+ *
+ * @return The # of pairs.
+ */
+static unsigned pairByName(const vector<const char*>& n1,
+                           const vector<const char*>& n2, IdList& match) {
+    match.assign(n2.size(), UINT_MAX);
+    map<string, unsigned> idx;
+    bool byName = true;
+    for (size_t i = 0, n = n1.size(); i < n && byName; ++i)
+        byName = isDesignName(n1[i]) && idx.insert(make_pair(n1[i], i)).second;
+    for (size_t j = 0, n = n2.size(); j < n && byName; ++j)
+        byName = isDesignName(n2[j]);
+    unsigned nPairs = 0;
+    if (byName) {
+        for (size_t j = 0, n = n2.size(); j < n; ++j) {
+            map<string, unsigned>::iterator it = idx.find(n2[j]);
+            if (it == idx.end() || it->second == UINT_MAX) continue;
+            match[j]   = it->second;
+            it->second = UINT_MAX;  // a name is paired once
+            ++nPairs;
+        }
+    } else if (n1.size() == n2.size()) {
+        for (size_t j = 0, n = n2.size(); j < n; ++j) match[j] = j;
+        nPairs = n2.size();
+    }
+    return nPairs;
+}
+
+// Literal of the miter for the literal v of a source circuit
+static inline CirGateV mapLit(const vector<CirGateV>& lits, const CirGateV& v) {
+    CirGateV m = lits[v.gate()->getGid()];
+    m.setInv(v.isInv());
+    return m;
+}
+
+/*************************************************/
+/*   Public member functions about the miter     */
+/*************************************************/
+/**
+ * @brief Builds the miter of two circuits into this (empty) manager.
+ *
+ * The PIs are paired by name (or by position if the names are missing),
+ * and a pair shares one PI. The AND gates of both circuits are created by
+ * createAndGate(), so the logic common to both is structurally hashed
+ * into one copy right away. Each pair of POs gives one miter PO, the XOR
+ * of the two. Without pairLatches, the latches of both circuits are kept
+ * (the product machine, for sequential equivalence). With pairLatches,
+ * the paired latches share one RO and the XOR of their next states is
+ * also a miter PO, i.e. the check is combinational under the latch
+ * correspondence. The gate IDs are laid out like those of readAig():
+ * PIs, ROs, ANDs, POs, RIs, then const 1. cm1 and cm2 are not changed.
+ *
+ * @return Returns false if there is nothing to compare.
+ */
+bool CirMgr::createMiter(CirMgr* cm1, CirMgr* cm2, bool pairLatches) {
+    assert(getNumTots() == 0);
+    CirMgr* cm[2] = {cm1, cm2};
+    vector<const char*> names[2];
+    IdList piMatch, roMatch, poMatch;
+
+    for (int k = 0; k < 2; ++k) {
+        cm[k]->updateDfsList();
+        names[k].clear();
+        for (unsigned i = 0, n = cm[k]->getNumPIs(); i < n; ++i)
+            names[k].push_back(cm[k]->getName(cm[k]->getPi(i)->getGid()));
+    }
+    const unsigned nPiPairs = pairByName(names[0], names[1], piMatch);
+    for (int k = 0; k < 2; ++k) {
+        names[k].clear();
+        for (unsigned i = 0, n = cm[k]->getNumPOs(); i < n; ++i)
+            names[k].push_back(cm[k]->getName(cm[k]->getPo(i)->getGid()));
+    }
+    const unsigned nPoPairs = pairByName(names[0], names[1], poMatch);
+    roMatch.assign(cm2->getNumLATCHs(), UINT_MAX);
+    unsigned nRoPairs = 0;
+    if (pairLatches) {
+        for (int k = 0; k < 2; ++k) {
+            names[k].clear();
+            for (unsigned i = 0, n = cm[k]->getNumLATCHs(); i < n; ++i)
+                names[k].push_back(cm[k]->getName(cm[k]->getRo(i)->getGid()));
+        }
+        nRoPairs = pairByName(names[0], names[1], roMatch);
+    }
+    if (nPoPairs + nRoPairs == 0) {
+        cerr << "Error: no output of \"" << cm1->getFileName()
+             << "\" can be paired with those of \"" << cm2->getFileName()
+             << "\"!!" << endl;
+        return false;
+    }
+    if (nPiPairs < cm1->getNumPIs() || nPiPairs < cm2->getNumPIs())
+        cerr << "Warning: " << (cm1->getNumPIs() + cm2->getNumPIs() - 2 * nPiPairs)
+             << " PIs are not paired and stay free in the miter" << endl;
+    if (nPoPairs < cm1->getNumPOs() || nPoPairs < cm2->getNumPOs())
+        cerr << "Warning: " << (cm1->getNumPOs() + cm2->getNumPOs() - 2 * nPoPairs)
+             << " POs are not paired and are not compared" << endl;
+    if (pairLatches && nRoPairs < cm2->getNumLATCHs())
+        cerr << "Warning: " << (cm2->getNumLATCHs() - nRoPairs)
+             << " latches of \"" << cm2->getFileName() << "\" are not paired"
+             << endl;
+
+    // lits[k][gid] ==> the miter literal of gate gid of circuit k
+    vector<CirGateV> lits[2];
+    for (int k = 0; k < 2; ++k) {
+        lits[k].assign(cm[k]->getNumTots(), CirGateV(_const0, false));
+        if (cm[k]->_const1)
+            lits[k][cm[k]->_const1->getGid()] = CirGateV(_const0, true);
+    }
+    _totGateList.push_back(_const0);
+    invalidateDfsList();  // rebuilt once at the end
+    _strashHash.init(getHashSize(2 * (cm1->getNumAIGs() + cm2->getNumAIGs())));
+
+    // PIs: those of cm1, then the unpaired ones of cm2
+    for (int k = 0; k < 2; ++k)
+        for (unsigned i = 0, n = cm[k]->getNumPIs(); i < n; ++i) {
+            const CirPiGate* src = cm[k]->getPi(i);
+            if (k == 1 && piMatch[i] != UINT_MAX) {
+                lits[1][src->getGid()] = lits[0][cm1->getPi(piMatch[i])->getGid()];
+                continue;
+            }
+            CirPiGate* pi = new CirPiGate(getNumTots());
+            if (const char* name = cm[k]->getName(src->getGid()))
+                setName(pi->getGid(), copyName(name));
+            addTotGate(pi);
+            _piList.push_back(pi);
+            lits[k][src->getGid()] = CirGateV(pi, false);
+        }
+    // ROs, with the circuit and the index of the latch driving each
+    vector<pair<int, unsigned> > roSrc;
+    for (int k = 0; k < 2; ++k)
+        for (unsigned i = 0, n = cm[k]->getNumLATCHs(); i < n; ++i) {
+            const CirRoGate* src = cm[k]->getRo(i);
+            if (k == 1 && roMatch[i] != UINT_MAX) {
+                lits[1][src->getGid()] = lits[0][cm1->getRo(roMatch[i])->getGid()];
+                continue;
+            }
+            CirRoGate* ro = new CirRoGate(getNumTots());
+            if (const char* name = cm[k]->getName(src->getGid()))
+                setName(ro->getGid(), copyName(name));
+            addTotGate(ro);
+            _roList.push_back(ro);
+            roSrc.push_back(make_pair(k, i));
+            lits[k][src->getGid()] = CirGateV(ro, false);
+        }
+    // ANDs, strashed across the two circuits
+    for (int k = 0; k < 2; ++k) {
+        const GateList& dfsList = cm[k]->getDfsList();
+        for (size_t i = 0, n = dfsList.size(); i < n; ++i) {
+            const CirGate* g = dfsList[i];
+            if (!g->isAig() || g == cm[k]->_const1) continue;
+            lits[k][g->getGid()] = createAndGate(mapLit(lits[k], g->getIn0()),
+                                                 mapLit(lits[k], g->getIn1()));
+        }
+    }
+    // POs: the XORs of the paired POs, then of the paired next states
+    for (unsigned j = 0, n = cm2->getNumPOs(); j < n; ++j) {
+        if (poMatch[j] == UINT_MAX) continue;
+        const CirPoGate* po1 = cm1->getPo(poMatch[j]);
+        CirGateV x = createXorGate(mapLit(lits[0], po1->getIn0()),
+                                   mapLit(lits[1], cm2->getPo(j)->getIn0()));
+        CirPoGate* po = new CirPoGate(getNumTots());
+        const char* name = cm1->getName(po1->getGid());
+        setName(po->getGid(), copyName(isDesignName(name)
+                                           ? string(name)
+                                           : "o" + to_string(getNumPOs())));
+        po->setIn0(x.gate(), x.isInv());
+        addTotGate(po);
+        _poList.push_back(po);
+    }
+    for (unsigned j = 0, n = cm2->getNumLATCHs(); j < n; ++j) {
+        if (roMatch[j] == UINT_MAX) continue;
+        const CirRoGate* ro1 = cm1->getRo(roMatch[j]);
+        CirGateV x = createXorGate(mapLit(lits[0], cm1->getRi(roMatch[j])->getIn0()),
+                                   mapLit(lits[1], cm2->getRi(j)->getIn0()));
+        CirPoGate* po = new CirPoGate(getNumTots());
+        const char* name = cm1->getName(ro1->getGid());
+        setName(po->getGid(), copyName((name ? string(name)
+                                             : "l" + to_string(roMatch[j])) +
+                                       "_ns"));
+        po->setIn0(x.gate(), x.isInv());
+        addTotGate(po);
+        _poList.push_back(po);
+    }
+    // RIs; a shared latch keeps the next state of cm1
+    for (size_t i = 0, n = roSrc.size(); i < n; ++i) {
+        const int k      = roSrc[i].first;
+        const CirGateV x = mapLit(lits[k], cm[k]->getRi(roSrc[i].second)->getIn0());
+        CirRiGate* ri    = new CirRiGate(getNumTots());
+        setName(ri->getGid(), copyName(to_string(ri->getGid()) + "_ns"));
+        ri->setIn0(x.gate(), x.isInv());
+        addTotGate(ri);
+        _riList.push_back(ri);
+        _roList[i]->setIn0(ri, false);
+    }
+    createConst1();
+    fileName = "miter";
+    genDfsList();
+
+    cout << "Miter: " << getNumPIs() << " PIs, " << getNumLATCHs()
+         << " latches, " << getNumPOs() << " outputs, " << getNumAIGs()
+         << " AIGs (" << cm1->getNumAIGs() << " + " << cm2->getNumAIGs()
+         << " before hashing)" << endl;
+    return true;
+}
+
+/**
+ * @brief Checks the outputs of a miter.
+ *
+ * The latches of a product machine (nCycles > 0) that are equivalent from
+ * reset are merged first by latchCorr(), which pairs the latches of the
+ * two circuits whenever it can prove them equivalent. The miter is then
+ * fraiged, so most of the equivalent pairs are merged and their outputs
+ * become const 0. Each remaining output is then checked
+ * by SAT with the PIs and ROs free; a satisfying assignment of a miter
+ * without latches is a counter-example. With latches, such an assignment
+ * may not be reachable. For a product machine (nCycles > 0), the output
+ * is then checked by BMC from reset (all latches 0) for nCycles cycles: a
+ * hit is a real counter-example, otherwise the output is unknown, since a
+ * proof needs the latch correspondence (CIRMiter -Latch). With paired
+ * latches (nCycles = 0), the paired ROs are shared and a BMC hit would
+ * not be real either, so the output is only "not proved".
+ *
+ * @return Returns true if every output is proved to be const 0.
+ */
+bool CirMgr::checkMiter(unsigned nCycles) {
+    if (nCycles && getNumLATCHs()) latchCorr();
+    fraig();
+    updateDfsList();
+
+    const CirFlatAig& flat = getFlatAig();
+    SolverV solver;
+    vector<int> vars;
+    flat.addToSolver(solver, vars);
+    const bool seq = getNumLATCHs() > 0;
+    size_t nProved = 0, nCexs = 0, nAborts = 0, nReports = 0, nNotProved = 0;
+    IdList latchPos;  // the outputs left to BMC
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i) {
+        const FlatLit l = flat.getPoLit(i);
+        if (l == 0) {  // const 0
+            ++nProved;
+            continue;
+        }
+        vec<Lit> assumps;
+        assumps.push(mkLit(vars[CirFlatAig::litIdx(l)], CirFlatAig::litInv(l)));
+        solver._conflictNum = CIR_MITER_EFFORT;
+        solver._aborted     = false;
+        const bool sat      = solver.solve(assumps);
+        if (!sat && !solver._aborted) {
+            ++nProved;
+            continue;
+        }
+        if (sat && seq && nCycles) {
+            latchPos.push_back(i);
+            continue;
+        }
+        if (!sat) ++nAborts;
+        else if (seq) ++nNotProved;
+        else ++nCexs;
+        if (nReports++ >= CIR_MITER_MAX_REPORTS) continue;
+        cout << "Output \"" << getName(getPo(i)->getGid()) << "\": ";
+        if (!sat) {
+            cout << "undecided" << endl;
+            continue;
+        }
+        cout << (seq ? "not proved" : "NOT equivalent") << "; counter-example ";
+        for (unsigned j = 1, m = flat.getAndBegin(); j < m; ++j) {
+            if (j == flat.getRoIdx(0) && seq) cout << " / ";
+            cout << (solver.model[vars[j]] == gv_l_True ? '1' : '0');
+        }
+        cout << endl;
+    }
+
+    size_t nUnknowns = 0;
+    if (!latchPos.empty()) {
+        IdList cycles, bounds;
+        vector<string> traces;
+        miterBmc(flat, latchPos, nCycles, cycles, bounds, traces);
+        for (size_t k = 0, n = latchPos.size(); k < n; ++k) {
+            if (cycles[k] != UINT_MAX) ++nCexs;
+            else ++nUnknowns;
+            if (nReports++ >= CIR_MITER_MAX_REPORTS) continue;
+            cout << "Output \"" << getName(getPo(latchPos[k])->getGid()) << "\": ";
+            if (cycles[k] != UINT_MAX)
+                cout << "NOT equivalent at cycle " << cycles[k]
+                     << " from reset; input trace " << traces[k] << endl;
+            else
+                cout << "unknown (needs -Latch pairing); no difference within "
+                     << bounds[k] << " cycles from reset" << endl;
+        }
+    }
+    if (nReports > CIR_MITER_MAX_REPORTS)
+        cout << "... " << nReports - CIR_MITER_MAX_REPORTS << " more" << endl;
+    cout << "Miter: " << nProved << " of " << getNumPOs() << " outputs proved, "
+         << nCexs << " disproved, ";
+    if (seq && nCycles) cout << nUnknowns << " unknown (needs -Latch pairing), ";
+    else if (seq) cout << nNotProved << " not proved (free latches), ";
+    cout << nAborts << " undecided" << endl;
+    if (nProved == getNumPOs())
+        cout << "The two circuits are equivalent." << endl;
+    else if (nCexs)
+        cout << "The two circuits are NOT equivalent." << endl;
+    return nProved == getNumPOs();
+}
+
+/**************************************************/
+/*   Private member functions about the miter     */
+/**************************************************/
+/**
+ * @brief Bounded model checking of some miter outputs from reset.
+ *
+ * One incremental solver gets a copy of the flat AIG per cycle, with the
+ * ROs of cycle 0 at 0 and those of cycle t + 1 equal to the RIs of cycle
+ * t. At each cycle, one SAT call checks the OR of the outputs still open;
+ * the outputs that are 1 in its model are disproved, and the call is
+ * repeated on the others until it is UNSAT.
+ *
+ * @param pos     The indices of the miter outputs to check.
+ * @param nCycles The # of cycles.
+ * @param cycles  Returns the first cycle at which pos[k] may be 1, or
+ *                UINT_MAX if none.
+ * @param bounds  Returns the # of cycles pos[k] is proved to be 0 from
+ *                reset (less than nCycles if a SAT call is aborted).
+ * @param traces  Returns the PI values of each cycle up to the hit,
+ *                separated by spaces.
+ */
+void CirMgr::miterBmc(const CirFlatAig& flat, const IdList& pos, unsigned nCycles,
+                      IdList& cycles, IdList& bounds, vector<string>& traces) const {
+    const size_t n = pos.size();
+    cycles.assign(n, UINT_MAX);
+    bounds.assign(n, 0);
+    traces.assign(n, string());
+    vector<bool> open(n, true);
+    size_t nOpen = n;
+    SolverV solver;
+    vector<vector<int> > vars(nCycles);
+    for (unsigned t = 0; t < nCycles && nOpen; ++t) {
+        flat.addToSolver(solver, vars[t]);
+        for (unsigned i = 0, m = flat.getNumLATCHs(); i < m; ++i) {
+            const Lit ro = mkLit(vars[t][flat.getRoIdx(i)]);
+            if (t == 0) {
+                solver.addUnit(~ro);
+                continue;
+            }
+            const FlatLit l = flat.getRiLit(i);
+            const Lit ri    = mkLit(vars[t - 1][CirFlatAig::litIdx(l)],
+                                    CirFlatAig::litInv(l));
+            solver.addBinary(~ro, ri);
+            solver.addBinary(ro, ~ri);
+        }
+        // One call on the OR of the open outputs; the hits are taken out
+        // and the others are checked again
+        while (nOpen) {
+            const Var d = solver.newVar();  // d ==> some open output is 1
+            vec<Lit> clause;
+            clause.push(mkLit(d, true));
+            for (size_t k = 0; k < n; ++k) {
+                if (!open[k]) continue;
+                const FlatLit l = flat.getPoLit(pos[k]);
+                clause.push(mkLit(vars[t][CirFlatAig::litIdx(l)], CirFlatAig::litInv(l)));
+            }
+            solver.addClause(clause);
+            vec<Lit> assumps;
+            assumps.push(mkLit(d));
+            solver._conflictNum = CIR_MITER_EFFORT;
+            solver._aborted     = false;
+            const bool sat      = solver.solve(assumps);
+            solver.addUnit(mkLit(d, true));  // retire this OR
+            if (!sat) {
+                if (solver._aborted) nOpen = 0;  // the bounds stay at t
+                else
+                    for (size_t k = 0; k < n; ++k)
+                        if (open[k]) bounds[k] = t + 1;
+                break;
+            }
+            string trace;
+            for (unsigned c = 0; c <= t; ++c) {
+                if (c) trace += ' ';
+                for (unsigned j = 0, m = flat.getNumPIs(); j < m; ++j)
+                    trace += solver.model[vars[c][flat.getPiIdx(j)]] == gv_l_True
+                                 ? '1' : '0';
+            }
+            for (size_t k = 0; k < n; ++k) {
+                if (!open[k]) continue;
+                const FlatLit l = flat.getPoLit(pos[k]);
+                const bool v    = solver.model[vars[t][CirFlatAig::litIdx(l)]] == gv_l_True;
+                if (v == CirFlatAig::litInv(l)) continue;  // 0 in this model
+                open[k]   = false;
+                cycles[k] = t;
+                traces[k] = trace;
+                --nOpen;
+            }
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/****************************************************************************
+  FileName     [ cirOpt.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define cir optimization functions ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <cassert>
+#include <iostream>
+
+#include "cirDef.h"
+#include "cirGate.h"
+#include "cirMgr.h"
+#include "util.h"
+
+using namespace std;
+
+/**************************************************/
+/*   Public member functions about optimization   */
+/**************************************************/
+// The literal that v stands for after the merges (see CirGate::merge())
+CirGateV CirMgr::getEqGateV(CirGateV v) {
+    CirGateV eq;
+    while ((eq = v.gate()->getEqGate()) != 0) {
+        bool inv = v.isInv();
+        v        = eq;
+        v.setInv(inv);
+    }
+    return v;
+}
+
+// Remove the AIG and UNDEF gates that cannot be reached from the POs/RIs
+// (_const1 is kept, since it may be used outside of the netlist)
+void CirMgr::sweep() {
+    genDfsList();  // only the fanin cones of the POs and RIs
+    CirGate::setGlobalRef();
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i)
+        _dfsList[i]->setToGlobalRef();
+    for (unsigned i = 1, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g == 0 || g == _const1 || g->isGlobalRef()) continue;
+        if (g->isAig()) {
+            cout << "Sweeping: AIG(" << i << ") removed..." << endl;
+            deleteAigGate(g);
+        } else if (g->isUndef()) {
+            cout << "Sweeping: UNDEF(" << i << ") removed..." << endl;
+            deleteUndefGate(g);
+        }
+    }
+    updateAfterRemoval();
+}
+
+// Trivial simplifications in topological order:
+//    (x & 0) = (x & !x) = 0,  (x & 1) = (x & x) = x
+void CirMgr::optimize() {
+    updateDfsList();
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        CirGate* g = _dfsList[i];
+        if (!g->isAig()) continue;
+        CirGateV out;
+        if (checkAigOptimize(g, getEqGateV(g->getIn0()),
+                             getEqGateV(g->getIn1()), out))
+            g->merge("Simplifying", out.gate(), out.isInv());
+    }
+    simplifyByEQ();
+}
+
+// return true if "g = in0 & in1" is trivial; "out" is then the literal
+// that replaces g
+bool CirMgr::checkAigOptimize(CirGate* g, const CirGateV& in0,
+                              const CirGateV& in1, CirGateV& out) const {
+    int c0 = getConstValue(in0), c1 = getConstValue(in1);
+    if (c0 == 0) out = in0;
+    else if (c1 == 0) out = in1;
+    else if (c0 == 1 || in0 == in1) out = in1;
+    else if (c1 == 1) out = in0;
+    else if (in0.gate() == in1.gate()) out = CirGateV(_const0, false);
+    else return false;
+    return true;
+}
+
+// Merge the AIG gates with the same fanins (after the earlier merges)
+void CirMgr::strash() {
+    updateDfsList();
+    StrashHash hash(getHashSize(_dfsList.size()));
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        CirGate* g = _dfsList[i];
+        if (!g->isAig()) continue;
+        CirStrashKey k(getEqGateV(g->getIn0())(), getEqGateV(g->getIn1())());
+        CirGate* h = 0;
+        if (hash.check(k, h)) g->merge("Strash", h, false);
+        else hash.forceInsert(k, g);
+    }
+    simplifyByEQ();
+}
+
+/***************************************************/
+/*   Private member functions about optimization   */
+/***************************************************/
+// Redirect all the fanins to the gates they are merged to, then delete the
+// merged gates
+void CirMgr::simplifyByEQ() {
+    for (unsigned i = 0, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g == 0 || g->getEqGate() != 0) continue;
+        unsigned nFanins = g->getNumFanins();
+        if (nFanins >= 1) {
+            CirGateV in0 = g->getIn0(), v = getEqGateV(in0);
+            if (v != in0) g->setIn0(v.gate(), v.isInv());
+        }
+        if (nFanins >= 2) {
+            CirGateV in1 = g->getIn1(), v = getEqGateV(in1);
+            if (v != in1) g->setIn1(v.gate(), v.isInv());
+        }
+    }
+    for (unsigned i = 1, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g != 0 && g->getEqGate() != 0) deleteAigGate(g);
+    }
+    updateAfterRemoval();
+}
+
+void CirMgr::deleteAigGate(CirGate* g) {
+    assert(g->isAig());
+    if (g == _const1) _const1 = 0;
+    _totGateList[g->getGid()] = 0;
+    delete static_cast<CirAigGate*>(g);  // ~CirGate() is not virtual
+}
+
+void CirMgr::deleteUndefGate(CirGate* g) {
+    assert(g->isUndef());
+    _totGateList[g->getGid()] = 0;
+    delete static_cast<CirUndefGate*>(g);
+}
+
+// Bring the gate lists, the strash table, the FEC groups and the DFS list
+// up to date after gates are deleted
+void CirMgr::updateAfterRemoval() {
+    // The deleted gates cannot be dereferenced ==> rebuild from the ID table
+    _aigList.clear();
+    for (unsigned i = 1, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g != 0 && g->isAig() && g != _const1)
+            _aigList.push_back(static_cast<CirAigGate*>(g));
+    }
+    resetStrash();
+    if (getNumFECGrps()) simplifyFECGrps();
+    genDfsList();
+}
@@ -0,0 +1,418 @@
+/****************************************************************************
+  FileName     [ cirRewrite.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the cut-based AIG rewriting ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <cassert>
+#include <climits>
+#include <iomanip>
+#include <iostream>
+
+#include "cirCut.h"
+#include "cirDef.h"
+#include "cirGate.h"
+#include "cirMgr.h"
+#include "util.h"
+
+using namespace std;
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// Decompositions of CirRwrLib::getCost(); the argument is in the low byte
+enum CirRwrChoice {
+    RWR_LEAF      = 0,  // const or literal
+    RWR_AND_VAR   = 1,  // f = ((v ^ p) & g) ^ inv; arg = v | p << 2 | inv << 3
+    RWR_XOR_VAR   = 2,  // f = v ^ f0; arg = v
+    RWR_MUX       = 3,  // f = v ? f1 : f0; arg = v
+    RWR_AND_SPLIT = 4,  // f = g(S1) & h(S2); arg = S1
+    RWR_OR_SPLIT  = 5,  // f = g(S1) | h(S2); arg = S1
+    RWR_XOR_SPLIT = 6   // f = g(S1) ^ h(S2); arg = S1
+};
+
+static const unsigned rwrVarMask[4] = {0xAAAA, 0xCCCC, 0xF0F0, 0xFF00};
+
+static inline unsigned rwrCof0(unsigned t, unsigned v) {
+    const unsigned l = t & ~rwrVarMask[v] & 0xFFFF;
+    return l | (l << (1 << v));
+}
+
+static inline unsigned rwrCof1(unsigned t, unsigned v) {
+    const unsigned h = t & rwrVarMask[v];
+    return h | (h >> (1 << v));
+}
+
+static unsigned rwrSupport(unsigned t) {
+    unsigned s = 0;
+    for (unsigned v = 0; v < 4; ++v)
+        if (rwrCof0(t, v) != rwrCof1(t, v)) s |= 1 << v;
+    return s;
+}
+
+// exists (or forall) the variables in vars
+static unsigned rwrQuantify(unsigned t, unsigned vars, bool exists) {
+    for (unsigned v = 0; v < 4; ++v)
+        if (vars & (1 << v))
+            t = exists ? (rwrCof0(t, v) | rwrCof1(t, v))
+                       : (rwrCof0(t, v) & rwrCof1(t, v));
+    return t;
+}
+
+static unsigned rwrRestrict0(unsigned t, unsigned vars) {
+    for (unsigned v = 0; v < 4; ++v)
+        if (vars & (1 << v)) t = rwrCof0(t, v);
+    return t;
+}
+
+/**************************************/
+/*   class CirRwrLib member functions  */
+/**************************************/
+const unsigned char CirRwrLib::_perms[24][4] = {
+    {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 1, 3}, {0, 2, 3, 1}, {0, 3, 1, 2},
+    {0, 3, 2, 1}, {1, 0, 2, 3}, {1, 0, 3, 2}, {1, 2, 0, 3}, {1, 2, 3, 0},
+    {1, 3, 0, 2}, {1, 3, 2, 0}, {2, 0, 1, 3}, {2, 0, 3, 1}, {2, 1, 0, 3},
+    {2, 1, 3, 0}, {2, 3, 0, 1}, {2, 3, 1, 0}, {3, 0, 1, 2}, {3, 0, 2, 1},
+    {3, 1, 0, 2}, {3, 1, 2, 0}, {3, 2, 0, 1}, {3, 2, 1, 0}};
+
+/**
+ * @brief Builds the NPN classes of the 4-input functions and a structure
+ *        for each class.
+ *
+ * The representative of a class is its smallest truth table. Its structure
+ * is the cheapest (as a tree) of the decompositions in getCost(), with the
+ * identical nodes shared.
+ */
+CirRwrLib::CirRwrLib() {
+    _classOf.assign(1 << 16, USHRT_MAX);
+    _trans.assign(1 << 16, 0);
+    _cost.assign(1 << 16, UCHAR_MAX);
+    _choice.assign(1 << 16, 0);
+    for (unsigned t = 0; t < (1 << 16); ++t) {
+        if (_classOf[t] != USHRT_MAX) continue;
+        const unsigned cls = _structs.size();
+        for (unsigned p = 0; p < 24; ++p)
+            for (unsigned ph = 0; ph < 32; ++ph) {
+                unsigned u = transform(t, p, ph);
+                if (_classOf[u] != USHRT_MAX) continue;
+                _classOf[u] = cls;
+                _trans[u]   = (p << 5) | ph;
+            }
+        _structs.push_back(CirRwrStruct());
+        getCost(t);
+        _structs.back()._out = synthesize(t, _structs.back());
+    }
+    vector<unsigned char>().swap(_cost);
+    vector<unsigned short>().swap(_choice);
+}
+
+// r(x) = t(y) ^ outInv, where y_i = x_perm[i] ^ inInv_i
+unsigned CirRwrLib::transform(unsigned t, unsigned perm, unsigned phase) {
+    unsigned r = 0;
+    for (unsigned x = 0; x < 16; ++x) {
+        unsigned y = 0;
+        for (unsigned i = 0; i < 4; ++i)
+            y |= (((x >> _perms[perm][i]) ^ (phase >> i)) & 1) << i;
+        if (((t >> y) ^ (phase >> 4)) & 1) r |= 1 << x;
+    }
+    return r;
+}
+
+// # of AND nodes of the cheapest decomposition (as a tree)
+#define RWR_TRY(cost, ch)        \
+    if ((c = (cost)) < best) { \
+        best   = c;              \
+        choice = (ch);           \
+    }
+unsigned CirRwrLib::getCost(unsigned t) {
+    if (_cost[t] != UCHAR_MAX) return _cost[t];
+    const unsigned supp = rwrSupport(t);
+    unsigned best = UCHAR_MAX - 1, choice = RWR_LEAF, c;
+    if (supp == 0 || (supp & (supp - 1)) == 0) best = 0;  // const or literal
+    for (unsigned v = 0; best && v < 4; ++v) {
+        if (!(supp & (1 << v))) continue;
+        const unsigned f0 = rwrCof0(t, v), f1 = rwrCof1(t, v);
+        if (f0 == 0) RWR_TRY(getCost(f1) + 1, (RWR_AND_VAR << 8) | v);
+        if (f1 == 0) RWR_TRY(getCost(f0) + 1, (RWR_AND_VAR << 8) | v | 4);
+        if (f0 == 0xFFFF) RWR_TRY(getCost(f1 ^ 0xFFFF) + 1, (RWR_AND_VAR << 8) | v | 8);
+        if (f1 == 0xFFFF) RWR_TRY(getCost(f0 ^ 0xFFFF) + 1, (RWR_AND_VAR << 8) | v | 12);
+        if (f1 == (f0 ^ 0xFFFF)) RWR_TRY(getCost(f0) + 3, (RWR_XOR_VAR << 8) | v);
+        RWR_TRY(getCost(f0) + getCost(f1) + 3, (RWR_MUX << 8) | v);
+    }
+    // disjoint-support splits; S1 always has the lowest support variable
+    const unsigned low = supp & (~supp + 1);
+    for (unsigned s1 = low; best && s1 < supp; s1 = ((s1 | ~supp) + 1) & supp) {
+        if (!(s1 & low)) continue;
+        const unsigned s2 = supp & ~s1;
+        unsigned g = rwrQuantify(t, s2, true), h = rwrQuantify(t, s1, true);
+        if ((g & h) == t) RWR_TRY(getCost(g) + getCost(h) + 1, (RWR_AND_SPLIT << 8) | s1);
+        g = rwrQuantify(t, s2, false), h = rwrQuantify(t, s1, false);
+        if ((g | h) == t) RWR_TRY(getCost(g) + getCost(h) + 1, (RWR_OR_SPLIT << 8) | s1);
+        g = rwrRestrict0(t, s2), h = rwrRestrict0(t, s1) ^ ((t & 1) ? 0xFFFF : 0);
+        if ((g ^ h) == t) RWR_TRY(getCost(g) + getCost(h) + 3, (RWR_XOR_SPLIT << 8) | s1);
+    }
+    _choice[t] = choice;
+    return _cost[t] = best;
+}
+#undef RWR_TRY
+
+// return the literal of t; the nodes are added to s
+unsigned CirRwrLib::synthesize(unsigned t, CirRwrStruct& s) {
+    if (t == 0) return 0;
+    if (t == 0xFFFF) return 1;
+    for (unsigned v = 0; v < 4; ++v) {
+        if (t == rwrVarMask[v]) return 2 * (v + 1);
+        if (t == (rwrVarMask[v] ^ 0xFFFF)) return 2 * (v + 1) + 1;
+    }
+    const unsigned arg = _choice[t] & 0xFF, v = arg & 3, x = 2 * (v + 1);
+    unsigned a, b, g, h;
+    switch (_choice[t] >> 8) {
+        case RWR_AND_VAR:
+            g = (arg & 4) ? rwrCof0(t, v) : rwrCof1(t, v);
+            if (arg & 8) g ^= 0xFFFF;
+            a = synthesize(g, s);
+            return addNode(s, x ^ ((arg >> 2) & 1), a) ^ ((arg >> 3) & 1);
+        case RWR_XOR_VAR:
+            a = x;
+            b = synthesize(rwrCof0(t, v), s);
+            break;
+        case RWR_MUX:
+            a = synthesize(rwrCof1(t, v), s);
+            b = synthesize(rwrCof0(t, v), s);
+            return addNode(s, addNode(s, x, a) ^ 1, addNode(s, x ^ 1, b) ^ 1) ^ 1;
+        case RWR_AND_SPLIT:
+            g = rwrQuantify(t, rwrSupport(t) & ~arg, true);
+            h = rwrQuantify(t, arg, true);
+            return addNode(s, synthesize(g, s), synthesize(h, s));
+        case RWR_OR_SPLIT:
+            g = rwrQuantify(t, rwrSupport(t) & ~arg, false);
+            h = rwrQuantify(t, arg, false);
+            return addNode(s, synthesize(g, s) ^ 1, synthesize(h, s) ^ 1) ^ 1;
+        case RWR_XOR_SPLIT:
+            a = synthesize(rwrRestrict0(t, rwrSupport(t) & ~arg), s);
+            b = synthesize(rwrRestrict0(t, arg) ^ ((t & 1) ? 0xFFFF : 0), s);
+            break;
+        default:
+            assert(0);
+            return 0;
+    }
+    // a ^ b = !(!(a & !b) & !(!a & b))
+    return addNode(s, addNode(s, a, b ^ 1) ^ 1, addNode(s, a ^ 1, b) ^ 1) ^ 1;
+}
+
+unsigned CirRwrLib::addNode(CirRwrStruct& s, unsigned a, unsigned b) const {
+    if (a > b) swap(a, b);
+    if (a == b || a == 1) return b;
+    if (a == 0 || a == (b ^ 1)) return 0;
+    for (unsigned k = 0, n = s._nodes.size(); k < n; ++k)
+        if (s._nodes[k].first == a && s._nodes[k].second == b) return 2 * (5 + k);
+    s._nodes.push_back(make_pair(a, b));
+    return 2 * (4 + s._nodes.size());
+}
+
+/***********************************************/
+/*   Public member functions about rewriting   */
+/***********************************************/
+/**
+ * @brief DAG-aware rewriting of the 4-input cuts.
+ *
+ * In topological order, each AND gate is tried with each of its 4-input
+ * priority cuts: the library structure of the cut function replaces the
+ * maximum fanout-free cone of the gate over the cut. The gain is the size
+ * of that cone minus the # of new gates needed, with the gates that already
+ * exist (by structural hashing) taken as free. The cut with the largest
+ * positive gain is applied. The replaced gates are merged by
+ * simplifyByEQ() at the end.
+ */
+void CirMgr::rewrite() {
+    static CirRwrLib lib;
+
+    genDfsList();  // the gates out of the PO/RI cones are left untouched
+    size_t nBefore = 0;
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i)
+        if (_dfsList[i]->isAig()) ++nBefore;
+    CirCutMan cutMan(4, CIR_CUT_MAX_CUTS);
+    cutMan.computeCuts(_dfsList, getNumTots());
+    if (_strashHash.numBuckets() == 0) initStrash();
+
+    // refs[gid] ==> # of fanouts in the current (rewritten) circuit; the
+    // fanouts out of the DFS list count too, so their fanins are kept
+    IdList refs(getNumTots(), 0);
+    vector<bool> inDfs(getNumTots(), false);
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i)
+        inDfs[_dfsList[i]->getGid()] = true;
+    for (unsigned i = 0, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g == 0 || g == _const1 || g->getEqGate() != 0) continue;
+        for (unsigned j = 0, m = g->getNumFanins(); j < m; ++j)
+            ++refs[getEqGateV(j ? g->getIn1() : g->getIn0()).gate()->getGid()];
+    }
+
+    const GateList dfsList = _dfsList;
+    size_t nRewrites = 0;
+    for (size_t i = 0, n = dfsList.size(); i < n; ++i) {
+        CirGate* g = dfsList[i];
+        if (!g->isAig() || g->getEqGate() != 0 || refs[g->getGid()] == 0)
+            continue;
+        int bestGain = 0;
+        unsigned bestCut = 0;
+        CirGateV ins[4];
+        for (unsigned c = 0, nc = cutMan.getNumCuts(g->getGid()) - 1; c < nc; ++c) {
+            const CirCut& cut = cutMan.getCut(g->getGid(), c);
+            if (!rwrGetInputs(cut, refs, ins)) continue;
+            const unsigned t = cut.getTruth() & 0xFFFF;
+            for (unsigned j = 0; j < cut.getNumLeaves(); ++j)
+                ++refs[ins[j].gate()->getGid()];  // the leaves stay
+            int saved = 1 + rwrDeref(g, refs);
+            unsigned nNew;
+            CirGateV out;
+            bool ok = rwrBuild(lib.getStruct(t), t, lib, ins, g, refs, true, nNew, out);
+            rwrRef(g, refs);
+            for (unsigned j = 0; j < cut.getNumLeaves(); ++j)
+                --refs[ins[j].gate()->getGid()];
+            if (ok && saved - int(nNew) > bestGain) {
+                bestGain = saved - nNew;
+                bestCut  = c;
+            }
+        }
+        if (bestGain <= 0) continue;
+
+        const CirCut& cut = cutMan.getCut(g->getGid(), bestCut);
+        const unsigned t  = cut.getTruth() & 0xFFFF;
+        rwrGetInputs(cut, refs, ins);
+        rwrDeref(g, refs);
+        unsigned nNew;
+        CirGateV out;
+        rwrBuild(lib.getStruct(t), t, lib, ins, g, refs, false, nNew, out);
+        CirGate* r = out.gate();
+        if (r->isAig() && refs[r->getGid()] == 0) rwrRef(r, refs);
+        refs[r->getGid()] += refs[g->getGid()];
+        refs[g->getGid()] = 0;
+        g->setEqGate(r, out.isInv());
+        ++nRewrites;
+    }
+
+    // The cones left without fanouts, including the gates that rwrBuild()
+    // created for one replacement and a later replacement dereferenced
+    inDfs.resize(getNumTots(), true);
+    refs.resize(getNumTots(), 0);
+    for (unsigned i = 1, n = getNumTots(); i < n; ++i) {
+        CirGate* g = _totGateList[i];
+        if (g != 0 && inDfs[i] && g->isAig() && g != _const1 &&
+            g->getEqGate() == 0 && refs[i] == 0)
+            deleteAigGate(g);
+    }
+    simplifyByEQ();
+
+    size_t nAfter = 0;
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i)
+        if (_dfsList[i]->isAig()) ++nAfter;
+    cout << "Rewrite: " << nRewrites << " cuts replaced; #AIG " << nBefore
+         << " -> " << nAfter;
+    if (nBefore)
+        cout << " (" << fixed << setprecision(2)
+             << 100.0 * (double(nAfter) - nBefore) / nBefore << "%)";
+    cout << endl;
+}
+
+/************************************************/
+/*   Private member functions about rewriting   */
+/************************************************/
+// The current literals of the cut leaves; return false if a leaf was
+// removed by an earlier rewrite
+bool CirMgr::rwrGetInputs(const CirCut& cut, const IdList& refs,
+                          CirGateV* ins) const {
+    for (unsigned j = 0; j < 4; ++j) {
+        if (j >= cut.getNumLeaves()) {
+            ins[j] = CirGateV(_const0, false);
+            continue;
+        }
+        ins[j]     = getEqGateV(CirGateV(_totGateList[cut.getLeaf(j)], false));
+        CirGate* f = ins[j].gate();
+        if (f->isAig() && refs[f->getGid()] == 0) return false;
+    }
+    return true;
+}
+
+// Remove the fanout references of g; return the # of AIG gates left
+// without fanouts (g excluded)
+unsigned CirMgr::rwrDeref(CirGate* g, IdList& refs) const {
+    unsigned n = 0;
+    for (unsigned j = 0; j < 2; ++j) {
+        CirGate* f = getEqGateV(j ? g->getIn1() : g->getIn0()).gate();
+        if (f->isAig() && --refs[f->getGid()] == 0) n += 1 + rwrDeref(f, refs);
+    }
+    return n;
+}
+
+// Inverse of rwrDeref()
+unsigned CirMgr::rwrRef(CirGate* g, IdList& refs) const {
+    unsigned n = 0;
+    for (unsigned j = 0; j < 2; ++j) {
+        CirGate* f = getEqGateV(j ? g->getIn1() : g->getIn0()).gate();
+        if (f->isAig() && refs[f->getGid()]++ == 0) n += 1 + rwrRef(f, refs);
+    }
+    return n;
+}
+
+/**
+ * @brief Instantiates a library structure over the cut leaves.
+ *
+ * @param s     The structure of the class of t.
+ * @param ins   The literals of the cut leaves.
+ * @param root  The gate to be replaced; the structure must not reuse it.
+ * @param dry   Only count the new gates (as create*Gate() would do).
+ * @param nNew  Returns the # of gates that are new or revived.
+ * @param out   Returns the output literal (only if !dry).
+ * @return      Returns false if the structure would reuse root.
+ */
+bool CirMgr::rwrBuild(const CirRwrStruct& s, unsigned t, const CirRwrLib& lib,
+                      const CirGateV* ins, const CirGate* root, IdList& refs,
+                      bool dry, unsigned& nNew, CirGateV& out) {
+    CirGateV lits[5 + 32];  // the literal encoding of CirRwrStruct
+    lits[0] = CirGateV(_const0, false);
+    for (unsigned i = 0; i < 4; ++i) {
+        lits[1 + i] = ins[lib.getInput(t, i)];
+        lits[1 + i].setInv(lib.isInputInv(t, i));
+    }
+    assert(s._nodes.size() <= 32);
+    nNew = 0;
+    for (unsigned k = 0, n = s._nodes.size(); k < n; ++k) {
+        CirGateV a = lits[s._nodes[k].first >> 1], b = lits[s._nodes[k].second >> 1];
+        a.setInv(s._nodes[k].first & 1);
+        b.setInv(s._nodes[k].second & 1);
+        CirGateV& v = lits[5 + k];
+        if (!dry) {
+            v = getEqGateV(createAndGate(a, b));
+            refs.resize(getNumTots(), 0);  // for the new gate
+            continue;
+        }
+        // Same as createAndGate(), without creating the gate
+        if (a.gate() == 0 || b.gate() == 0) {
+            v = CirGateV();
+            ++nNew;
+            continue;
+        }
+        int c0 = getConstValue(a), c1 = getConstValue(b);
+        CirGate* h = 0;
+        if (c0 == 0) v = a;
+        else if (c1 == 0) v = b;
+        else if (c0 == 1 || a == b) v = b;
+        else if (c1 == 1) v = a;
+        else if (a == ~b) v = CirGateV(_const0, false);
+        else if (_strashHash.check(CirStrashKey(a(), b()), h)) {
+            v = getEqGateV(CirGateV(h, false));
+            if (v.gate() == root) return false;
+            if (v.gate()->isAig() && refs[v.gate()->getGid()] == 0)
+                ++nNew;  // in the removed cone
+        } else {
+            v = CirGateV();
+            ++nNew;
+        }
+    }
+    out = lits[s._out >> 1];
+    out.setInv((s._out & 1) != lib.isOutputInv(t));
+    return dry || out.gate() != root;
+}
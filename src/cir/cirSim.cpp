@@ -11,11 +11,16 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 #include "cirDef.h"
+#include "cirFlat.h"
 #include "cirGate.h"
 #include "cirMgr.h"
 #include "util.h"
@@ -27,6 +32,10 @@ using namespace std;
 
 static bool debug_g = false;
 
+// # of CIR_SIM_WORDS blocks simulated by each thread per round in
+// parallelRandomSim()
+#define CIR_PSIM_BLOCKS 4
+
 /*******************************/
 /*   Global variable and enum  */
 /*******************************/
@@ -34,26 +43,126 @@ static bool debug_g = false;
 /**************************************/
 /*   Static varaibles and functions   */
 /**************************************/
-static inline void checkFecHash(FECHash &fecHash, CirGate *g) {
-    IdList *ll   = 0;
-    CirPValue pv = g->getPValue();
-    //    if (fecHash.check(pv, ll)) {
-    //       ll->push_back(g->getGid() * 2);
-    //    }
-    //    else if (fecHash.check(~pv, ll)) {
-    //       ll->push_back(g->getGid() *2 + 1);
-    //    }
-    //    else {
-    //       ll = new IdList(1);
-    //       (*ll)[0] = g->getGid() * 2;
-    //       fecHash.forceInsert(pv, ll);
-    //    }
+// Sort key of a gate in FEC refinement: (hash, litId) of its value
+// normalized to have bit 0 = 0, so a value and its complement get the same
+// key (litId phase = 1 for the complemented members)
+typedef pair<size_t, unsigned> FECKey;
+
+static inline FECKey getFECKey(const CirPValue &pv, unsigned gid) {
+    if (pv.getWord(0) & 1) return FECKey((~pv)(), gid * 2 + 1);
+    return FECKey(pv(), gid * 2);
+}
+
+// same normalized value?
+static inline bool isSameFECValue(const CirPValue &v1, bool inv1,
+                                  const CirPValue &v2, bool inv2) {
+    const size_t m = (inv1 != inv2) ? ~size_t(0) : 0;
+    for (size_t w = 0; w < CIR_SIM_WORDS; ++w)
+        if (v1.getWord(w) != (v2.getWord(w) ^ m)) return false;
+    return true;
+}
+
+// wall-clock time in seconds
+static inline double simWallTime() {
+    return chrono::duration<double>(
+               chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Per-thread random number generator (splitmix64), so that the patterns of
+// a block only depend on its seed
+static inline size_t simRandWord(size_t &state) {
+    size_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z        = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z        = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
 }
 
+// Worker of parallelRandomSim(): simulate random values on the PIs and ROs
+// of the (read-only) flat AIG into the thread's own value buffer
+static void simRandomBlocks(const CirFlatAig *flat, size_t seed,
+                            vector<size_t> *values) {
+    const size_t nWords = CIR_SIM_WORDS * CIR_PSIM_BLOCKS;
+    values->resize(size_t(flat->getNumObjs()) * nWords);
+    size_t *val = &(*values)[0];
+    for (size_t i = nWords, n = flat->getAndBegin() * nWords; i < n; ++i)
+        val[i] = simRandWord(seed);
+    flat->simulate(*values, nWords);
+}
+
+// The threads of parallelRandomSim(): the caller is thread 0 and the
+// nThreads - 1 workers stay alive for the whole call. In round r, thread t
+// runs simRandomBlocks() with seed + r * nThreads + t into values[t].
+class CirRandSimPool {
+public:
+    CirRandSimPool(const CirFlatAig &flat, unsigned nThreads, size_t seed,
+                   vector<vector<size_t> > &values)
+        : _flat(flat), _nThreads(nThreads), _seed(seed), _values(values),
+          _round(0), _job(0), _nDone(0), _stop(false) {
+        for (unsigned t = 1; t < _nThreads; ++t)
+            _workers.push_back(thread(&CirRandSimPool::work, this, t));
+    }
+    ~CirRandSimPool() {
+        {
+            lock_guard<mutex> lock(_mutex);
+            _stop = true;
+        }
+        _start.notify_all();
+        for (size_t t = 0, n = _workers.size(); t < n; ++t) _workers[t].join();
+    }
+
+    // Returns when all the threads are done with the round
+    void simulate(size_t round) {
+        {
+            lock_guard<mutex> lock(_mutex);
+            _round = round;
+            _nDone = 0;
+            ++_job;
+        }
+        _start.notify_all();
+        simulateBlocks(0, round);
+        unique_lock<mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _nDone + 1 == _nThreads; });
+    }
+
+private:
+    const CirFlatAig &_flat;
+    unsigned _nThreads;
+    size_t _seed;
+    vector<vector<size_t> > &_values;
+    vector<thread> _workers;
+    mutex _mutex;
+    condition_variable _start, _done;
+    size_t _round, _job;  // the current round; # of rounds so far
+    unsigned _nDone;      // # of workers done with the current round
+    bool _stop;
+
+    void simulateBlocks(unsigned t, size_t round) {
+        simRandomBlocks(&_flat, _seed + round * _nThreads + t, &_values[t]);
+    }
+    void work(unsigned t) {
+        size_t done = 0;
+        while (true) {
+            size_t round;
+            {
+                unique_lock<mutex> lock(_mutex);
+                _start.wait(lock, [this, done] { return _stop || _job != done; });
+                if (_stop) return;
+                done  = _job;
+                round = _round;
+            }
+            simulateBlocks(t, round);
+            lock_guard<mutex> lock(_mutex);
+            if (++_nDone + 1 == _nThreads) _done.notify_one();
+        }
+    }
+};
+
 /************************************************/
 /*   Public member functions about Simulation   */
 /************************************************/
-void CirMgr::randomSim() {
+void CirMgr::randomSim(unsigned nThreads) {
+    updateDfsList();
     size_t nSims = 0, nFails = 0;
     size_t MAX_FAILS = 3;  // 3;
     unsigned nin     = getNumPIs();
@@ -66,130 +175,320 @@ void CirMgr::randomSim() {
     size_t nfv = _fecVector.size();
     m          = (m + nfv) / (nfv + 1);
     MAX_FAILS  = unsigned(m);
+    double start = simWallTime();
+    _simTime     = 0;
+    _fecTime     = 0;
+    _fecRounds   = 0;
     if (debug_g)
         cout << "MAX_FAILS = " << MAX_FAILS << endl;
-    cout << "Total #FEC Group = " << _fecGrps.size() << flush;
+    cout << "Total #FEC Group = " << getNumFECGrps() << flush;
     for (size_t i = 0; i < nfv; ++i) {
         setPPattern(_fecVector[i]);
         if (!simAndCheckFEC()) ++nFails;
-        nSims += 64;
-        if (_simLog) outputSimLog();
+        nSims += CIR_SIM_PATTERNS;
+        if (_simLog) outputSimLog(CIR_SIM_PATTERNS);
         cout << char(13) << setw(30) << ' ' << char(13)
-             << "Total #FEC Group = " << _fecGrps.size() << flush;
-    }
-    while (nFails < MAX_FAILS) {
-        setRandPPattern();
-        if (!simAndCheckFEC()) ++nFails;
-        nSims += 64;
-        if (_simLog) outputSimLog();
-        cout << char(13) << setw(30) << ' ' << char(13)
-             << "Total #FEC Group = " << _fecGrps.size() << flush;
+             << "Total #FEC Group = " << getNumFECGrps() << flush;
     }
+    parallelRandomSim(nThreads, MAX_FAILS, nFails, nSims);
     finalizeFEC();
     cout << char(13) << setw(30) << ' ' << char(13) << nSims
          << " patterns simulated." << endl;
+    reportFECTime();
+    if (_simProfile) reportSimProfile(nSims, start);
     //   _fecMgr.print();
 }
 
+// Random simulation on nThreads threads (CIRSIMulate -Random [-Threads])
+// In each round, every thread simulates CIR_PSIM_BLOCKS blocks of random
+// patterns on the flat AIG, each thread in its own value buffer; the netlist
+// is only read. The blocks are then applied to the FEC groups one by one in
+// thread order. The patterns of the k-th group of blocks only depend on k
+// (and the seed drawn here), so the same blocks are refined in the same
+// order for any nThreads and the FEC groups do not depend on it. The
+// worker threads are created once per call (CirRandSimPool); with one
+// thread, everything runs in the calling thread. The latch outputs are
+// random (free) inputs, as in the SAT checks of fraig().
+void CirMgr::parallelRandomSim(unsigned nThreads, size_t maxFails,
+                               size_t &nFails, size_t &nSims) {
+    const CirFlatAig &flat = getFlatAig();
+    const size_t nWords    = CIR_SIM_WORDS * CIR_PSIM_BLOCKS;
+    const size_t seed      = size_t(rnGen(INT_MAX)) << 32;
+    vector<vector<size_t> > values(nThreads);
+    CirRandSimPool pool(flat, nThreads, seed, values);
+    for (size_t round = 0; nFails < maxFails; ++round) {
+        double t = simWallTime();
+        pool.simulate(round);
+        _simTime += simWallTime() - t;
+
+        for (unsigned i = 0; i < nThreads && nFails < maxFails; ++i)
+            for (size_t b = 0; b < CIR_PSIM_BLOCKS && nFails < maxFails; ++b) {
+                setFlatPValues(flat, values[i], nWords, b * CIR_SIM_WORDS);
+                if (!refineFEC()) ++nFails;
+                nSims += CIR_SIM_PATTERNS;
+                if (_simLog) outputSimLog(CIR_SIM_PATTERNS);
+            }
+        cout << char(13) << setw(30) << ' ' << char(13)
+             << "Total #FEC Group = " << getNumFECGrps() << flush;
+    }
+}
+
+// Copy one block (CIR_SIM_WORDS words from word w) of the flat AIG values
+// to the PIs, ROs, AIG gates and POs
+void CirMgr::setFlatPValues(const CirFlatAig &flat, const vector<size_t> &values,
+                            size_t nWords, size_t w) const {
+    CirPValue v;
+    for (unsigned i = 1, n = flat.getNumObjs(); i < n; ++i) {
+        v.setWords(&values[i * nWords + w]);
+        setPValue(flat.getGid(i), v);
+    }
+    for (unsigned i = 0, n = flat.getNumPOs(); i < n; ++i) {
+        FlatLit l = flat.getPoLit(i);
+        v.setWords(&values[CirFlatAig::litIdx(l) * nWords + w]);
+        if (CirFlatAig::litInv(l)) v = ~v;
+        setPValue(_poList[i]->getGid(), v);
+    }
+}
+
 void CirMgr::fileSim(ifstream &patternFile) {
+    updateDfsList();
     unsigned nSims = 0, nin = getNumPIs();
+    double start   = simWallTime();
+    _simTime       = 0;
+    _fecTime       = 0;
+    _fecRounds     = 0;
+    if (_simEvent) _eventSim = new CirEventSim(getFlatAig(), CIR_SIM_WORDS);
     while (!patternFile.eof()) {
-        size_t patterns[nin];
+        size_t patterns[nin * CIR_SIM_WORDS];
         unsigned nPatterns = gatherPatterns(patternFile, patterns, nin);
         if (!nPatterns) break;
         setPPattern(patterns);
         simAndCheckFEC();
         nSims += nPatterns;
         if (_simLog) outputSimLog(nPatterns);
-        cout << char(13) << "Total #FEC Group = " << _fecGrps.size() << flush;
+        cout << char(13) << "Total #FEC Group = " << getNumFECGrps() << flush;
     }
     finalizeFEC();
     cout << char(13) << nSims << " patterns simulated." << endl;
+    reportFECTime();
+    if (_eventSim) {
+        size_t nRounds = _eventSim->getNumRounds();
+        size_t nEvals  = _eventSim->getNumEvals();
+        size_t nFull   = nRounds * getFlatAig().getNumAnds();
+        cout << "Event-driven: " << nEvals << " AIG evaluations in " << nRounds
+             << " rounds";
+        if (nRounds)
+            cout << " (" << setprecision(4) << double(nEvals) / nRounds
+                 << " per round, " << double(nEvals) / (nSims ? nSims : 1)
+                 << " per pattern, "
+                 << (nFull ? 100.0 * nEvals / nFull : 0.0)
+                 << "% of full sweeps)";
+        cout << endl;
+        delete _eventSim;
+        _eventSim = 0;
+    }
+    if (_simProfile) reportSimProfile(nSims, start);
+}
+
+// Sequential simulation of CIR_SIM_PATTERNS random traces for nCycles
+// cycles. All the latches start from the init state (0); in each cycle the
+// PIs get new random values, the AIG is simulated once and the latch inputs
+// (RI) are clocked into the latch outputs (RO).
+// With nThreads > 1, each cycle is simulated level by level on a pool of
+// nThreads threads kept for the whole run (the traces depend on each other
+// across cycles, so the patterns cannot be split as in parallelRandomSim()).
+// A monitor PO fails when it is 1 on some trace. The first failure of each
+// monitor (the whole list of POs if monitor < 0) is reported, and the input
+// sequence of the earliest one is printed (and written to the sim log).
+// return true if any monitor fails
+bool CirMgr::seqSim(unsigned nCycles, int monitor, unsigned nThreads) {
+    const CirFlatAig &flat = getFlatAig();
+    const size_t nWords    = CIR_SIM_WORDS;
+    const unsigned nPIs = flat.getNumPIs(), nLATCHs = flat.getNumLATCHs();
+    vector<size_t> values(size_t(flat.getNumObjs()) * nWords, 0);
+    vector<size_t> nextState(size_t(nLATCHs) * nWords);
+    CirSimPool pool(flat, nThreads);
+
+    IdList monitors;
+    if (monitor >= 0) monitors.push_back(monitor);
+    else
+        for (unsigned i = 0, n = getNumPOs(); i < n; ++i) monitors.push_back(i);
+    // first failure of each monitor: (cycle, trace); UINT_MAX if none
+    vector<pair<unsigned, unsigned> > fails(monitors.size(),
+                                            make_pair(UINT_MAX, UINT_MAX));
+    unsigned nFails = 0, firstFail = UINT_MAX;
+
+    const size_t seed = size_t(rnGen(INT_MAX));
+    size_t rnState    = seed;
+    double start      = simWallTime();
+    _simTime          = 0;
+    unsigned cycle    = 0;
+    for (; cycle < nCycles && nFails < monitors.size(); ++cycle) {
+        for (unsigned i = 0; i < nPIs; ++i)
+            for (size_t w = 0; w < nWords; ++w)
+                values[flat.getPiIdx(i) * nWords + w] = simRandWord(rnState);
+        double t = simWallTime();
+        pool.simulate(values, nWords);
+        _simTime += simWallTime() - t;
+
+        for (size_t i = 0, n = monitors.size(); i < n; ++i) {
+            if (fails[i].first != UINT_MAX) continue;
+            FlatLit l = flat.getPoLit(monitors[i]);
+            for (size_t w = 0; w < nWords; ++w) {
+                size_t v = CirFlatAig::getLitValue(values, l, nWords, w);
+                if (!v) continue;
+                unsigned bit = 0;
+                while (!((v >> bit) & 1)) ++bit;
+                fails[i] = make_pair(cycle, unsigned(w * 64 + bit));
+                if (firstFail == UINT_MAX) firstFail = i;
+                ++nFails;
+                break;
+            }
+        }
+
+        // clock the latches: RO(t+1) = RI(t)
+        for (unsigned i = 0; i < nLATCHs; ++i)
+            for (size_t w = 0; w < nWords; ++w)
+                nextState[i * nWords + w] =
+                    CirFlatAig::getLitValue(values, flat.getRiLit(i), nWords, w);
+        for (unsigned i = 0; i < nLATCHs; ++i)
+            for (size_t w = 0; w < nWords; ++w)
+                values[flat.getRoIdx(i) * nWords + w] = nextState[i * nWords + w];
+    }
+
+    cout << cycle << " cycles of " << CIR_SIM_PATTERNS
+         << " traces simulated." << endl;
+    for (size_t i = 0, n = monitors.size(); i < n; ++i) {
+        if (fails[i].first == UINT_MAX) continue;
+        const CirPoGate *po = _poList[monitors[i]];
+        cout << "Output " << monitors[i];
+        if (const char *name = getName(po->getGid())) cout << " (" << name << ")";
+        cout << " fails at cycle " << fails[i].first << " on trace "
+             << fails[i].second << endl;
+    }
+    if (monitors.size() > nFails)
+        cout << (monitors.size() - nFails) << " of " << monitors.size()
+             << " monitor(s) never fail." << endl;
+
+    // Replay the random stream to get the inputs of the earliest failure
+    if (firstFail != UINT_MAX) {
+        const unsigned failCycle = fails[firstFail].first;
+        const unsigned trace     = fails[firstFail].second;
+        const size_t word = trace / 64, bit = trace % 64;
+        cout << "Counter-example of output " << monitors[firstFail]
+             << " (PI values per cycle):" << endl;
+        rnState = seed;
+        for (unsigned c = 0; c <= failCycle; ++c) {
+            string str(nPIs, '0');
+            for (unsigned i = 0; i < nPIs; ++i)
+                for (size_t w = 0; w < nWords; ++w) {
+                    size_t v = simRandWord(rnState);
+                    if (w == word && ((v >> bit) & 1)) str[i] = '1';
+                }
+            cout << "  " << setw(6) << right << c << ": " << str << endl;
+            if (_simLog) (*_simLog) << str << endl;
+        }
+        cout << left;
+    }
+    if (_simProfile) reportSimProfile(size_t(cycle) * CIR_SIM_PATTERNS, start);
+    return (nFails != 0);
 }
 
 // return true if new FEC pairs are generated
 bool CirMgr::simAndCheckFEC() {
-    pSim1Pattern();
+    double t = _simProfile ? simWallTime() : 0;
+    if (_eventSim) eventSim1Pattern();
+    else pSim1Pattern();
+    if (_simProfile) _simTime += simWallTime() - t;
+    return refineFEC();
+}
+
+// Refine the FEC groups by the current simulation values of the gates
+// return true if new FEC pairs are generated
+bool CirMgr::refineFEC() {
     if (isFlag(NO_FEC)) return false;
-    if (_fecGrps.empty()) return initFEC();
-    else return checkFEC();
+    double t = simWallTime();
+    bool ret = _fecGrpStart.empty() ? initFEC() : checkFEC();
+    _fecTime += simWallTime() - t;
+    ++_fecRounds;
+    return ret;
 }
 
 // Make sure the circuit has been simulated!!
+// All the candidates (const 0 and the AIG gates) start in one group
 bool CirMgr::initFEC() {
-    FECHash fecHash;
-    fecHash.init(getHashSize(_dfsList.size()));
-    checkFecHash(fecHash, _const0);  // make sure 0 is in HashMap
+    _fecLits.clear();
+    _fecLits.push_back(0);  // _const0
     for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
         CirGate *g = _dfsList[i];
-        if (g->isAig()) checkFecHash(fecHash, g);
-    }
-
-    // Collect valid FEC groups
-    for (FECHash::iterator hi = fecHash.begin(); hi != fecHash.end(); ++hi) {
-        IdList *ll = (*hi).second;
-        if (ll->size() == 1) {
-            delete ll;
-            continue;
-        }
-        _fecGrps.push_back(ll);
-    }
-    if (_fecGrps.empty()) {
-        setFlag(NO_FEC);
-        return false;
+        if (g->isAig()) _fecLits.push_back(g->getGid() * 2);
     }
-    return true;
+    _fecGrpStart.clear();
+    _fecGrpStart.push_back(0);
+    _fecGrpStart.push_back(_fecLits.size());
+    checkFEC();
+    return !_fecLits.empty();
 }
 
-// return true if _fecGrps changes!!
+// Split every group by the current values in one pass over _fecLits.
+// Each group is sorted by FECKey and cut into runs of equal values; runs of
+// size 1 are dropped. The new groups are compacted in place, since they never
+// take more room than the old ones.
+// return true if the groups change!!
 bool CirMgr::checkFEC() {
-    vector<IdList *> newGrps;
-    bool grpChange = false;
-    for (size_t i = 0, n = _fecGrps.size(); i < n; ++i) {
-        IdList *ll = _fecGrps[i];
-        grpChange |= checkFECRecur(*ll, newGrps);
-    }
-    _fecGrps.swap(newGrps);
-    for (size_t i = 0, n = newGrps.size(); i < n; ++i)
-        delete newGrps[i];
-    if (_fecGrps.empty()) setFlag(NO_FEC);
-    return grpChange;
-}
-
-bool CirMgr::checkFECRecur(const IdList &ll, vector<IdList *> &newGrps) {
-    FECHash fecHash;
-    size_t n = ll.size();  // Note: n can be 0
-    fecHash.init(getHashSize(n));
-    for (size_t i = 0; i < n; ++i) {
-        CirGate *g = litId2Gate(ll[i]);
-        checkFecHash(fecHash, g);
-    }
+    const size_t nGrps = getNumFECGrps(), nLits = _fecLits.size();
+    IdList newStart;
+    newStart.reserve(_fecGrpStart.size());
+    newStart.push_back(0);
+    size_t out = 0;
+    for (size_t i = 0; i < nGrps; ++i) {
+        const size_t b = _fecGrpStart[i], e = _fecGrpStart[i + 1];
+        _fecKeys.resize(e - b);
+        for (size_t j = b; j < e; ++j)
+            _fecKeys[j - b] = getFECKey(getPValue(_fecLits[j] / 2), _fecLits[j] / 2);
+        ::sort(_fecKeys.begin(), _fecKeys.end());
 
-    // Collect valid FEC groups
-    size_t nNewGrps = 0;
-    for (FECHash::iterator hi = fecHash.begin(); hi != fecHash.end(); ++hi) {
-        IdList *nn = (*hi).second;
-        if (nn->size() == 1) {
-            delete nn;
-            continue;
+        for (size_t j = 0, m = _fecKeys.size(); j < m;) {
+            size_t k = j + 1;
+            while (k < m && _fecKeys[k].first == _fecKeys[j].first) ++k;
+            // [j, k) have the same hash; split them by value if they collide
+            while (j < k) {
+                const CirPValue &v0 = getPValue(_fecKeys[j].second / 2);
+                bool inv0     = _fecKeys[j].second & 1;
+                size_t grpEnd = j + 1;
+                for (size_t l = j + 1; l < k; ++l) {
+                    const CirPValue &v = getPValue(_fecKeys[l].second / 2);
+                    if (isSameFECValue(v0, inv0, v, _fecKeys[l].second & 1))
+                        swap(_fecKeys[grpEnd++], _fecKeys[l]);
+                }
+                if (grpEnd - j > 1) {
+                    for (size_t l = j; l < grpEnd; ++l)
+                        _fecLits[out++] = _fecKeys[l].second;
+                    newStart.push_back(out);
+                }
+                j = grpEnd;
+            }
         }
-        newGrps.push_back(nn);
-        ++nNewGrps;
     }
-    return (nNewGrps != 1);
+    _fecLits.resize(out);
+    bool grpChange = (out != nLits) || (newStart.size() != nGrps + 1);
+    _fecGrpStart.swap(newStart);
+    if (_fecLits.empty()) setFlag(NO_FEC);
+    return grpChange;
 }
 
 void CirMgr::finalizeFEC() {
     CirGate::setGlobalRef();
-    for (size_t i = 0, n = _fecGrps.size(); i < n; ++i) {
-        IdList *ll = _fecGrps[i];
-        sort(ll->begin(), ll->end());
-        if ((*ll)[0] % 2 != 0)  // isInv
-            for (size_t j = 0, m = ll->size(); j < m; ++j) (*ll)[j] ^= 1;
-        for (size_t j = 0, m = ll->size(); j < m; ++j) {
-            CirGate *g = litId2Gate((*ll)[j]);
+    for (size_t i = 0, n = getNumFECGrps(); i < n; ++i) {
+        IdList::iterator b = _fecLits.begin() + _fecGrpStart[i];
+        IdList::iterator e = _fecLits.begin() + _fecGrpStart[i + 1];
+        sort(b, e);
+        if (*b % 2 != 0)  // isInv
+            for (IdList::iterator it = b; it != e; ++it) *it ^= 1;
+        for (IdList::iterator it = b; it != e; ++it) {
+            CirGate *g = litId2Gate(*it);
             g->setToGlobalRef();
-            g->setFECId(i * 2 + (*ll)[j] % 2);
+            g->setFECId(i * 2 + *it % 2);
         }
     }
     for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
@@ -202,63 +501,56 @@ void CirMgr::finalizeFEC() {
         _const0->resetFECId();
 }
 
+// Remove the deleted gates from the FEC groups (in place)
 void CirMgr::simplifyFECGrps() {
-    vector<IdList *> newGrps;
-    for (size_t i = 0, n = _fecGrps.size(); i < n; ++i) {
-        IdList *ll        = _fecGrps[i];
-        size_t validGates = 0;
-        for (size_t j = 0, m = ll->size(); j < m; ++j)
-            if (litId2Gate((*ll)[j]) != 0) ++validGates;
-        if (validGates > 1) {
-            IdList *nn     = new IdList(validGates);
-            unsigned fecId = newGrps.size() * 2;
-            for (size_t j = 0, k = 0, m = ll->size(); j < m; ++j) {
-                CirGate *g = litId2Gate((*ll)[j]);
-                if (g != 0) {
-                    (*nn)[k++] = (*ll)[j];
-                    g->setFECId(fecId + ((*ll)[j] & 0x1));
-                }
-            }
-            newGrps.push_back(nn);
-        } else if (validGates == 1)
-            for (size_t j = 0, m = ll->size(); j < m; ++j) {
-                CirGate *g = litId2Gate((*ll)[j]);
-                if (g != 0) g->resetFECId();
-            }
+    IdList newStart(1, 0);
+    size_t out = 0;
+    for (size_t i = 0, n = getNumFECGrps(); i < n; ++i) {
+        const size_t b = _fecGrpStart[i], e = _fecGrpStart[i + 1];
+        size_t grpBegin = out;
+        for (size_t j = b; j < e; ++j)
+            if (litId2Gate(_fecLits[j]) != 0) _fecLits[out++] = _fecLits[j];
+        if (out - grpBegin > 1) {
+            unsigned fecId = (newStart.size() - 1) * 2;
+            for (size_t j = grpBegin; j < out; ++j)
+                litId2Gate(_fecLits[j])->setFECId(fecId + (_fecLits[j] & 0x1));
+            newStart.push_back(out);
+        } else {
+            if (out > grpBegin) litId2Gate(_fecLits[grpBegin])->resetFECId();
+            out = grpBegin;
+        }
     }
-    newGrps.swap(_fecGrps);
-    for (size_t i = 0, n = newGrps.size(); i < n; ++i) delete newGrps[i];
+    _fecLits.resize(out);
+    _fecGrpStart.swap(newStart);
 }
 
 void CirMgr::clearFECGrps() {
-    for (size_t i = 0, n = _fecGrps.size(); i < n; ++i) delete _fecGrps[i];
     for (size_t i = 0, n = getNumTots(); i < n; ++i)
         if (_totGateList[i]) _totGateList[i]->resetFECId();
-    clearList(_fecGrps);
+    clearList(_fecLits);
+    clearList(_fecGrpStart);
 }
 
 void CirMgr::printFEC() const {
-    size_t n = _fecGrps.size();
+    size_t n = getNumFECGrps();
     cout << "Total #FEC Group = " << n << endl;
     for (size_t i = 0; i < n; ++i) {
-        IdList *ll = _fecGrps[i];
-        cout << "[" << i << "] " << litId2Gate((*ll)[0])->getPValue() << endl;
-        for (size_t j = 0, m = ll->size(); j < m; ++j)
-            cout << litId2GateV((*ll)[j]) << endl;
+        cout << "[" << i << "] " << getPValue(getFECLit(i, 0) / 2)
+             << endl;
+        for (size_t j = 0, m = getFECGrpSize(i); j < m; ++j)
+            cout << litId2GateV(getFECLit(i, j)) << endl;
     }
 }
 
 /*************************************************/
 /*   Private member functions about Simulation   */
 /*************************************************/
-void CirMgr::setRandPPattern() const {
-    for (unsigned i = 0, n = getNumPIs(); i < n; ++i)
-        _piList[i]->setRandPPattern();
-}
-
 void CirMgr::setPPattern(SimPattern const patterns) const {
-    for (size_t i = 0, n = getNumPIs(); i < n; ++i)
-        _piList[i]->setPValue(patterns[i]);
+    for (size_t i = 0, n = getNumPIs(); i < n; ++i) {
+        CirPValue v;
+        v.setWords(patterns + i * CIR_SIM_WORDS);
+        setPValue(_piList[i]->getGid(), v);
+    }
 }
 
 // return false if:
@@ -266,9 +558,10 @@ void CirMgr::setPPattern(SimPattern const patterns) const {
 // (2) EOF is encountered
 unsigned CirMgr::gatherPatterns(ifstream &patternFile, SimPattern const patterns, size_t nin) {
     unsigned nPatterns = 0;
-    for (size_t i = 0; i < nin; ++i) patterns[i] = size_t(0);
+    for (size_t i = 0, n = nin * CIR_SIM_WORDS; i < n; ++i)
+        patterns[i] = size_t(0);
     string str;
-    while (nPatterns < 64) {
+    while (nPatterns < CIR_SIM_PATTERNS) {
         patternFile >> str;
         if (patternFile.eof()) return nPatterns;
         if (nin != str.size()) {
@@ -277,9 +570,10 @@ unsigned CirMgr::gatherPatterns(ifstream &patternFile, SimPattern const patterns
                  << ") in a circuit!!" << endl;
             return 0;
         }
+        const size_t w = nPatterns / 64;
         for (size_t i = 0; i < nin; ++i) {
             if (str[i] == '1')
-                patterns[i] += (size_t(1) << nPatterns);
+                patterns[i * CIR_SIM_WORDS + w] |= (size_t(1) << (nPatterns % 64));
             else if (str[i] != '0') {
                 cerr << "\nError: Pattern(" << str << ") contains a non-0/1 "
                      << "character(\'" << str[i] << "\')." << endl;
@@ -288,61 +582,152 @@ unsigned CirMgr::gatherPatterns(ifstream &patternFile, SimPattern const patterns
         }
         ++nPatterns;
     }
-    assert(nPatterns == 64);
+    assert(nPatterns == CIR_SIM_PATTERNS);
     return nPatterns;
 }
 
+// Simulate one word (64 patterns) of the PI values through _dfsList.
+// This is the inner loop of all the simulation commands; keep it free of
+// any I/O or bookkeeping.
+// The gates dispatch on their type tags; the values are in _pValues. An RO
+// takes the value of its RI from the previous call.
 void CirMgr::pSim1Pattern() const {
-    for (unsigned i = 0, n = _dfsList.size(); i < n; ++i) {
-        cout << _dfsList[i]->getTypeStr() << "\n";
-        if (_dfsList[i]->getTypeStr() == "RI") {
-            cout << endl;
+    if (_pValues.size() < getNumTots()) _pValues.resize(getNumTots());
+    CirPValue *pv        = &_pValues[0];
+    CirGate *const *dfs = _dfsList.empty() ? 0 : &_dfsList[0];
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        const CirGate *g = dfs[i];
+        CirGateV in0, in1;
+        switch (g->getType()) {
+            case AIG_GATE:
+                in0 = static_cast<const CirAigGate *>(g)->getIn0();
+                in1 = static_cast<const CirAigGate *>(g)->getIn1();
+                pv[g->getGid()].setAnd(pv[in0.gateId()], in0.isInv(),
+                                       pv[in1.gateId()], in1.isInv());
+                break;
+            case PO_GATE:
+                in0 = static_cast<const CirPoGate *>(g)->getIn0();
+                pv[g->getGid()].setBuf(pv[in0.gateId()], in0.isInv());
+                break;
+            case RI_GATE:
+                in0 = static_cast<const CirRiGate *>(g)->getIn0();
+                pv[g->getGid()].setBuf(pv[in0.gateId()], in0.isInv());
+                break;
+            case RO_GATE:
+                in0 = static_cast<const CirRoGate *>(g)->getIn0();
+                pv[g->getGid()].setBuf(pv[in0.gateId()], in0.isInv());
+                break;
+            default:  // PI and const: set by the caller
+                break;
         }
-        _dfsList[i]->pSim();
     }
 }
 
+// Same as pSim1Pattern(), but only the gates affected by the PIs/ROs that
+// change since the last call are re-evaluated (by _eventSim). Like in
+// pSim1Pattern(), an RO takes the value of its RI from the previous call.
+void CirMgr::eventSim1Pattern() {
+    assert(_eventSim != 0);
+    const CirFlatAig &flat = getFlatAig();
+    size_t words[CIR_SIM_WORDS];
+    for (unsigned i = 0, n = flat.getNumLATCHs(); i < n; ++i) {
+        const CirPValue &v = getPValue(_riList[i]->getGid());
+        for (size_t w = 0; w < CIR_SIM_WORDS; ++w) words[w] = v.getWord(w);
+        _eventSim->setInput(flat.getRoIdx(i), words);
+    }
+    for (unsigned i = 0, n = flat.getNumPIs(); i < n; ++i) {
+        const CirPValue &v = getPValue(_piList[i]->getGid());
+        for (size_t w = 0; w < CIR_SIM_WORDS; ++w) words[w] = v.getWord(w);
+        _eventSim->setInput(flat.getPiIdx(i), words);
+    }
+    _eventSim->propagate();
+
+    // write back the changed values only
+    CirPValue v;
+    const IdList &changed = _eventSim->getChanged();
+    for (size_t i = 0, n = changed.size(); i < n; ++i) {
+        v.setWords(_eventSim->getValue(changed[i]));
+        setPValue(flat.getGid(changed[i]), v);
+    }
+    for (unsigned i = 0, n = flat.getNumPOs(); i < n; ++i) {
+        FlatLit l = flat.getPoLit(i);
+        v.setWords(_eventSim->getValue(CirFlatAig::litIdx(l)));
+        if (CirFlatAig::litInv(l)) v = ~v;
+        setPValue(_poList[i]->getGid(), v);
+    }
+    for (unsigned i = 0, n = flat.getNumLATCHs(); i < n; ++i) {
+        FlatLit l = flat.getRiLit(i);
+        v.setWords(_eventSim->getValue(CirFlatAig::litIdx(l)));
+        if (CirFlatAig::litInv(l)) v = ~v;
+        setPValue(_riList[i]->getGid(), v);
+    }
+}
+
+void CirMgr::reportFECTime() const {
+    cout << "FEC refinement: " << _fecRounds << " rounds, " << setprecision(4)
+         << _fecTime << " seconds";
+    if (_fecRounds)
+        cout << " (" << setprecision(4) << 1e3 * _fecTime / _fecRounds
+             << " ms per round)";
+    cout << endl;
+}
+
+// Report the simulation throughput (for CIRSIMulate -Profile)
+// "kernel" only counts the time in pSim1Pattern() and the flat AIG
+// simulation; "total" also includes pattern generation/parsing, FEC
+// refinement and logging.
+void CirMgr::reportSimProfile(size_t nSims, double start) const {
+    double total = simWallTime() - start;
+    cout << "Simulation profile: " << nSims << " patterns, "
+         << _dfsList.size() << " gates" << endl;
+    cout << "  total  : " << setprecision(4) << total << " seconds";
+    if (total > 0) cout << " (" << size_t(nSims / total) << " patterns/sec)";
+    cout << endl;
+    cout << "  kernel : " << setprecision(4) << _simTime << " seconds";
+    if (_simTime > 0)
+        cout << " (" << size_t(nSims / _simTime) << " patterns/sec)";
+    cout << endl;
+}
+
 void CirMgr::outputSimLog(size_t nPatterns) {
     assert(_simLog != 0);
     unsigned nin  = getNumPIs();
     unsigned nout = getNumPOs();
-    size_t patterns[nin], responses[nout];
-    for (unsigned i = 0; i < nin; ++i)
-        patterns[i] = _piList[i]->getPValue()();
-    for (unsigned i = 0; i < nout; ++i)
-        responses[i] = _poList[i]->getPValue()();
 
-    assert(nPatterns <= 64);
+    assert(nPatterns <= CIR_SIM_PATTERNS);
     for (size_t i = 0; i < nPatterns; ++i) {
-        for (unsigned j = 0; j < nin; ++j) {
-            (*_simLog) << (patterns[j] & 0x1);
-            patterns[j] >>= 1;
-        }
+        for (unsigned j = 0; j < nin; ++j)
+            (*_simLog) << getPValue(_piList[j]->getGid()).getBit(i);
         (*_simLog) << " ";
-        for (unsigned j = 0; j < nout; ++j) {
-            (*_simLog) << (responses[j] & 0x1);
-            responses[j] >>= 1;
-        }
+        for (unsigned j = 0; j < nout; ++j)
+            (*_simLog) << getPValue(_poList[j]->getGid()).getBit(i);
         (*_simLog) << endl;
     }
 }
 
 void CirPValue::rand() {
-    _pValue = size_t(0);
-    for (int i = 0; i < 4; ++i)
-        _pValue += size_t(rnGen(1 << 16) << i * 16);
+    for (size_t w = 0; w < CIR_SIM_WORDS; ++w) {
+        _pValue[w] = size_t(0);
+        for (int i = 0; i < 4; ++i)
+            _pValue[w] += size_t(rnGen(1 << 16)) << i * 16;
+    }
 }
 
 static const char *pvBin[16] = {
     "0000", "0001", "0010", "0011", "0100", "0101", "0110", "0111",
     "1000", "1001", "1010", "1011", "1100", "1101", "1110", "1111"};
 
+// The most significant word is printed first; words are separated by ' '
 ostream &operator<<(ostream &os, const CirPValue &v) {
     const size_t nBinMinus1 = 15, binShift = nBinMinus1 * 4;
-    os << pvBin[v._pValue >> binShift] << pvBin[v._pValue << 4 >> binShift];
-    for (size_t i = 2; i <= nBinMinus1; i += 2)
-        os << '_' << pvBin[v._pValue << (i * 4) >> binShift]
-           << pvBin[v._pValue << ((i + 1) * 4) >> binShift];
+    for (size_t w = CIR_SIM_WORDS; w-- > 0;) {
+        const size_t pv = v._pValue[w];
+        os << pvBin[pv >> binShift] << pvBin[pv << 4 >> binShift];
+        for (size_t i = 2; i <= nBinMinus1; i += 2)
+            os << '_' << pvBin[pv << (i * 4) >> binShift]
+               << pvBin[pv << ((i + 1) * 4) >> binShift];
+        if (w) os << ' ';
+    }
     return os;
 }
 
@@ -0,0 +1,270 @@
+/****************************************************************************
+  FileName     [ cirTernary.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the ternary (0/1/X) simulation ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <cassert>
+#include <climits>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+#include "cirDef.h"
+#include "cirFlat.h"
+#include "cirGate.h"
+#include "cirMgr.h"
+#include "util.h"
+
+using namespace std;
+
+// # of POs and latches listed in the reports
+#define CIR_TERNARY_MAX_REPORTS 10
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// splitmix64
+static inline size_t ternaryRandWord(size_t& state) {
+    size_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z        = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z        = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline void setTernaryRow(vector<size_t>& values, unsigned i,
+                                 size_t nWords, size_t w, size_t may0,
+                                 size_t may1) {
+    values[(size_t(i) * 2) * nWords + w]     = may0;
+    values[(size_t(i) * 2 + 1) * nWords + w] = may1;
+}
+
+// '0', '1' or 'X' of bit 0 of word 0
+static inline char getTernaryChar(const vector<size_t>& values, FlatLit l) {
+    const bool may0 = CirFlatAig::getLitMay0(values, l, 1, 0) & 1;
+    const bool may1 = CirFlatAig::getLitMay1(values, l, 1, 0) & 1;
+    return (may0 && may1) ? 'X' : (may1 ? '1' : '0');
+}
+
+// Set the RO rows to the initial state: init[i] is '0', '1' or 'X' for
+// latch i, or init is empty for reset (all latches 0)
+static void setTernaryInit(const CirFlatAig& flat, const string& init,
+                           vector<size_t>& values, size_t nWords) {
+    for (unsigned i = 0, n = flat.getNumLATCHs(); i < n; ++i) {
+        const char c = init.empty() ? '0' : init[i];
+        for (size_t w = 0; w < nWords; ++w)
+            setTernaryRow(values, flat.getRoIdx(i), nWords, w,
+                          (c != '1') ? ~size_t(0) : 0,
+                          (c != '0') ? ~size_t(0) : 0);
+    }
+}
+
+// Clock the latches of the simulated values: RO(t+1) = RI(t)
+static void ternaryClock(const CirFlatAig& flat, vector<size_t>& values,
+                         size_t nWords, vector<size_t>& next) {
+    const unsigned nLATCHs = flat.getNumLATCHs();
+    next.resize(size_t(nLATCHs) * 2 * nWords);
+    for (unsigned i = 0; i < nLATCHs; ++i)
+        for (size_t w = 0; w < nWords; ++w) {
+            next[(size_t(i) * 2) * nWords + w] =
+                CirFlatAig::getLitMay0(values, flat.getRiLit(i), nWords, w);
+            next[(size_t(i) * 2 + 1) * nWords + w] =
+                CirFlatAig::getLitMay1(values, flat.getRiLit(i), nWords, w);
+        }
+    for (unsigned i = 0; i < nLATCHs; ++i)
+        for (size_t w = 0; w < nWords; ++w)
+            setTernaryRow(values, flat.getRoIdx(i), nWords, w,
+                          next[(size_t(i) * 2) * nWords + w],
+                          next[(size_t(i) * 2 + 1) * nWords + w]);
+}
+
+/**
+ * Ternary state sequence with all the PIs X, from the initial state init
+ * (see setTernaryInit()). states[c][i] / pos[c][i] is '0', '1' or 'X' for
+ * latch / PO i at cycle c. The states over-approximate the reachable ones
+ * of each cycle, so once a state repeats, the sequence covers all the
+ * reachable states.
+ *
+ * @return The cycle where the repeated state first appears (the sequence
+ *         is periodic from there), or UINT_MAX if no state repeats within
+ *         maxCycles cycles.
+ */
+static unsigned ternaryTrajectory(const CirFlatAig& flat, const string& init,
+                                  unsigned maxCycles, vector<string>& states,
+                                  vector<string>& pos) {
+    const unsigned nLATCHs = flat.getNumLATCHs(), nPOs = flat.getNumPOs();
+    vector<size_t> values(size_t(flat.getNumObjs()) * 2, 0), next;
+    for (unsigned i = 0; i < flat.getNumPIs(); ++i)
+        setTernaryRow(values, flat.getPiIdx(i), 1, 0, ~size_t(0), ~size_t(0));
+    setTernaryInit(flat, init, values, 1);
+    states.clear();
+    pos.clear();
+    map<string, unsigned> seen;
+    for (unsigned c = 0; c < maxCycles; ++c) {
+        string s(nLATCHs, '0');
+        for (unsigned i = 0; i < nLATCHs; ++i)
+            s[i] = getTernaryChar(values, FlatLit(flat.getRoIdx(i) * 2));
+        pair<map<string, unsigned>::iterator, bool> ret =
+            seen.insert(make_pair(s, c));
+        if (!ret.second) return ret.first->second;
+        states.push_back(s);
+        flat.simulateTernary(values, 1);
+        string p(nPOs, '0');
+        for (unsigned i = 0; i < nPOs; ++i)
+            p[i] = getTernaryChar(values, flat.getPoLit(i));
+        pos.push_back(p);
+        ternaryClock(flat, values, 1, next);
+    }
+    return UINT_MAX;
+}
+
+// The value of position i if it is the same constant in all of
+// strs[begin, end), or 'X' otherwise
+static inline char ternaryConst(const vector<string>& strs, unsigned begin,
+                                unsigned end, unsigned i) {
+    const char v = strs[begin][i];
+    for (unsigned c = begin + 1; c < end && v != 'X'; ++c)
+        if (strs[c][i] != v) return 'X';
+    return v;
+}
+
+/*******************************************************/
+/*   Public member functions about ternary simulation  */
+/*******************************************************/
+/**
+ * @brief Ternary (0/1/X) simulation for reset analysis and X-propagation.
+ *
+ * Without randPIs, all the PIs are X and the ternary state sequence is
+ * run until a state repeats (at most nCycles cycles). From then on the
+ * sequence covers all the reachable states, so the latches and POs that
+ * stay constant are constant in every reachable state; with X latches in
+ * the initial state, the latches that become and stay constant are those
+ * that the reset sequence initializes.
+ *
+ * With randPIs, CIR_SIM_PATTERNS traces of random binary PIs are run for
+ * nCycles cycles and the X-leakage to the POs is reported. The PIs are
+ * never X here, so init should have some X latch.
+ *
+ * @param init '0', '1' or 'X' for each latch, or empty for reset (all 0).
+ * @return Returns true if some PO may be X.
+ */
+bool CirMgr::ternarySim(unsigned nCycles, const string& init, bool randPIs) {
+    updateDfsList();
+    const CirFlatAig& flat = getFlatAig();
+    const unsigned nLATCHs = getNumLATCHs(), nPOs = getNumPOs();
+    vector<unsigned> poXCycle(nPOs, UINT_MAX);  // first cycle PO i is X
+    vector<size_t> poXTraces(nPOs, 0);          // # traces X at that cycle
+
+    if (!randPIs) {
+        vector<string> states, pos;
+        const unsigned loop =
+            ternaryTrajectory(flat, init, nCycles, states, pos);
+        const unsigned end = states.size();
+        if (loop == UINT_MAX) {
+            cout << "Ternary simulation: no ternary state repeats within "
+                 << nCycles << " cycles; the constants are not conclusive."
+                 << endl;
+        } else {
+            cout << "Ternary simulation: the state of cycle " << end
+                 << " repeats that of cycle " << loop << "." << endl;
+            unsigned nConsts[2] = {0, 0}, nStable[2] = {0, 0};
+            for (unsigned i = 0; i < nLATCHs; ++i) {
+                const char a = ternaryConst(states, 0, end, i);
+                const char e = ternaryConst(states, loop, end, i);
+                if (a != 'X') ++nConsts[a - '0'];
+                else if (e != 'X') ++nStable[e - '0'];
+            }
+            cout << "Latches constant in every reachable state: "
+                 << nConsts[0] + nConsts[1] << " of " << nLATCHs << " ("
+                 << nConsts[0] << " at 0, " << nConsts[1] << " at 1)" << endl;
+            cout << "Latches constant after " << loop << " cycles: "
+                 << nStable[0] + nStable[1] << " more (" << nStable[0]
+                 << " at 0, " << nStable[1] << " at 1)" << endl;
+            unsigned nPoConsts = 0;
+            for (unsigned i = 0; i < nPOs; ++i)
+                if (ternaryConst(pos, 0, end, i) != 'X') ++nPoConsts;
+            cout << "Outputs constant in every reachable state: " << nPoConsts
+                 << " of " << nPOs << endl;
+        }
+        for (unsigned c = 0; c < end; ++c)
+            for (unsigned i = 0; i < nPOs; ++i)
+                if (pos[c][i] == 'X' && poXCycle[i] == UINT_MAX) {
+                    poXCycle[i]  = c;
+                    poXTraces[i] = 1;
+                }
+    } else {
+        const size_t nWords = CIR_SIM_WORDS;
+        vector<size_t> values(size_t(flat.getNumObjs()) * 2 * nWords, 0), next;
+        setTernaryInit(flat, init, values, nWords);
+        size_t rnState = size_t(rnGen(INT_MAX));
+        for (unsigned c = 0; c < nCycles; ++c) {
+            for (unsigned i = 0; i < flat.getNumPIs(); ++i)
+                for (size_t w = 0; w < nWords; ++w) {
+                    const size_t r = ternaryRandWord(rnState);
+                    setTernaryRow(values, flat.getPiIdx(i), nWords, w, ~r, r);
+                }
+            flat.simulateTernary(values, nWords);
+            for (unsigned i = 0; i < nPOs; ++i) {
+                if (poXCycle[i] != UINT_MAX) continue;
+                size_t nX = 0;
+                for (size_t w = 0; w < nWords; ++w)
+                    nX += __builtin_popcountll(
+                        CirFlatAig::getLitMay0(values, flat.getPoLit(i), nWords, w) &
+                        CirFlatAig::getLitMay1(values, flat.getPoLit(i), nWords, w));
+                if (nX) {
+                    poXCycle[i]  = c;
+                    poXTraces[i] = nX;
+                }
+            }
+            ternaryClock(flat, values, nWords, next);
+        }
+        size_t nXLatches = 0;
+        for (unsigned i = 0; i < nLATCHs; ++i)
+            for (size_t w = 0; w < nWords; ++w)
+                if (values[(size_t(flat.getRoIdx(i)) * 2) * nWords + w] &
+                    values[(size_t(flat.getRoIdx(i)) * 2 + 1) * nWords + w]) {
+                    ++nXLatches;
+                    break;
+                }
+        cout << nCycles << " cycles of " << CIR_SIM_PATTERNS
+             << " ternary traces simulated; " << nXLatches << " of " << nLATCHs
+             << " latches are still X in some trace." << endl;
+    }
+
+    unsigned nXPOs = 0;
+    for (unsigned i = 0; i < nPOs; ++i) {
+        if (poXCycle[i] == UINT_MAX) continue;
+        if (nXPOs++ >= CIR_TERNARY_MAX_REPORTS) continue;
+        cout << "Output " << i;
+        if (const char* name = getName(_poList[i]->getGid()))
+            cout << " (" << name << ")";
+        cout << " may be X from cycle " << poXCycle[i];
+        if (randPIs) cout << " (" << poXTraces[i] << " traces)";
+        cout << endl;
+    }
+    if (nXPOs > CIR_TERNARY_MAX_REPORTS)
+        cout << "... " << nXPOs - CIR_TERNARY_MAX_REPORTS << " more" << endl;
+    cout << "X reaches " << nXPOs << " of " << nPOs << " outputs." << endl;
+    return nXPOs != 0;
+}
+
+/**
+ * @brief Finds the latches that are 0 in every reachable state, by
+ *        ternary simulation from reset with all the PIs X.
+ *
+ * @param consts    Returns the indices of the constant latches.
+ * @param maxCycles The limit of the ternary state sequence.
+ * @return Returns false (and no latch) if no state repeats in time.
+ */
+bool CirMgr::getConstLatches(IdList& consts, unsigned maxCycles) {
+    consts.clear();
+    updateDfsList();
+    vector<string> states, pos;
+    if (ternaryTrajectory(getFlatAig(), "", maxCycles, states, pos) == UINT_MAX)
+        return false;
+    for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i)
+        if (ternaryConst(states, 0, states.size(), i) == '0') consts.push_back(i);
+    return true;
+}
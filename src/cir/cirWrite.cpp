@@ -0,0 +1,397 @@
+/****************************************************************************
+  FileName     [ cirWrite.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the streaming netlist writers ]
+  Author       [ Design Verification Lab ]
+  Copyright    [ Copyright(c) 2023-present DVLab, GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <zlib.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+
+#include "cirDef.h"
+#include "cirGate.h"
+#include "cirMgr.h"
+#include "util.h"
+
+using namespace std;
+
+// Size of the output buffer; the writers never flush per line
+#define CIR_WRITE_BUF_SIZE (1 << 20)
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// Output buffer of the writers: the text is formatted straight into one
+// large buffer, which goes to an ostream or a gzip stream when full
+class CirWriteBuf {
+public:
+    CirWriteBuf(ostream& os) : _os(&os), _gz(0), _size(0), _bytes(0), _fail(false) {
+        _buf = new char[CIR_WRITE_BUF_SIZE];
+    }
+    CirWriteBuf(gzFile gz) : _os(0), _gz(gz), _size(0), _bytes(0), _fail(false) {
+        _buf = new char[CIR_WRITE_BUF_SIZE];
+    }
+    ~CirWriteBuf() {
+        flush();
+        delete[] _buf;
+    }
+
+    CirWriteBuf& operator<<(char c) {
+        if (_size == CIR_WRITE_BUF_SIZE) flush();
+        _buf[_size++] = c;
+        return *this;
+    }
+    CirWriteBuf& operator<<(const char* s) { return write(s, strlen(s)); }
+    CirWriteBuf& operator<<(const string& s) { return write(s.data(), s.size()); }
+    CirWriteBuf& operator<<(size_t n) {
+        char tmp[24];
+        unsigned k = sizeof(tmp);
+        do {
+            tmp[--k] = '0' + n % 10;
+            n /= 10;
+        } while (n);
+        return write(tmp + k, sizeof(tmp) - k);
+    }
+    CirWriteBuf& operator<<(unsigned n) { return *this << size_t(n); }
+
+    CirWriteBuf& write(const char* s, size_t n) {
+        if (_size + n > CIR_WRITE_BUF_SIZE) {
+            flush();
+            if (n > CIR_WRITE_BUF_SIZE) return put(s, n);
+        }
+        memcpy(_buf + _size, s, n);
+        _size += n;
+        return *this;
+    }
+    void flush() {
+        if (_size) put(_buf, _size);
+        _size = 0;
+    }
+    size_t getNumBytes() const { return _bytes + _size; }
+    bool fail() const { return _fail; }
+
+private:
+    ostream* _os;
+    gzFile _gz;
+    char* _buf;
+    size_t _size;
+    size_t _bytes;  // flushed
+    bool _fail;
+
+    CirWriteBuf(const CirWriteBuf&);  // not copyable
+    CirWriteBuf& operator=(const CirWriteBuf&);
+
+    CirWriteBuf& put(const char* s, size_t n) {
+        if (_os) {
+            _os->write(s, n);
+            if (!*_os) _fail = true;
+        } else if (gzwrite(_gz, s, n) != int(n))
+            _fail = true;
+        _bytes += n;
+        return *this;
+    }
+};
+
+static void putDelta(CirWriteBuf& buf, unsigned x) {
+    while (x & ~0x7fU) {
+        buf << char((x & 0x7f) | 0x80);
+        x >>= 7;
+    }
+    buf << char(x);
+}
+
+// Net of a gate in the BLIF file; the PIs and ROs keep their names, the
+// other nets are "<prefix><gate ID>"
+static string blifNet(const CirMgr* mgr, const CirGate* g, const string& prefix) {
+    const char* name = (g->isPi() || g->isRo()) ? mgr->getName(g->getGid()) : 0;
+    return name ? string(name) : prefix + to_string(g->getGid());
+}
+
+// out = in (or !in)
+static void writeBlifBuf(CirWriteBuf& buf, const CirMgr* mgr, const CirGateV& in,
+                         const string& out, const string& prefix) {
+    buf << ".names " << blifNet(mgr, in.gate(), prefix) << ' ' << out << '\n'
+        << (in.isInv() ? "0 1\n" : "1 1\n");
+}
+
+/************************************************/
+/*   Public member functions about the writers  */
+/************************************************/
+/**
+ * @brief Writes the netlist (or the fanin cone of a gate) to a file.
+ *
+ * The file is written in one pass through a CIR_WRITE_BUF_SIZE buffer and
+ * compressed on the fly if gzip is set. The size and the throughput are
+ * reported.
+ *
+ * @param fileName The output file.
+ * @param type     AAG, AIGER or BLIF.
+ * @param gzip     Write a gzip file.
+ * @param g        Only the fanin cone of g is written (AAG only), if not 0.
+ * @return         Returns false if the file cannot be written.
+ */
+bool CirMgr::writeFile(const string& fileName, FileType type, bool gzip,
+                       CirGate* g) const {
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    ofstream outfile;
+    gzFile gz = 0;
+    if (gzip) gz = gzopen(fileName.c_str(), "wb");
+    else outfile.open(fileName.c_str(), ios::out | ios::binary);
+    if (gzip ? (gz == 0) : !outfile) {
+        cerr << "Error: cannot open \"" << fileName << "\"!!" << endl;
+        return false;
+    }
+
+    CirWriteBuf* buf = gzip ? new CirWriteBuf(gz) : new CirWriteBuf(outfile);
+    if (type == AIGER) writeAig(*buf);
+    else if (type == BLIF) writeBlif(*buf, fileName);
+    else if (g) writeGate(*buf, g);
+    else writeAag(*buf);
+    buf->flush();
+    const size_t nBytes = buf->getNumBytes();
+    bool fail           = buf->fail();
+    delete buf;
+    if (gzip) fail = (gzclose(gz) != Z_OK) || fail;
+    else {
+        outfile.close();
+        fail = !outfile || fail;
+    }
+    if (fail) {
+        cerr << "Error: failed to write \"" << fileName << "\"!!" << endl;
+        return false;
+    }
+
+    const double sec =
+        chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Wrote " << nBytes << " bytes" << (gzip ? " (before gzip)" : "")
+         << " to \"" << fileName << "\" in " << fixed << setprecision(3) << sec
+         << " seconds";
+    if (sec > 0) cout << " (" << setprecision(1) << nBytes / sec / 1e6 << " MB/s)";
+    cout << endl;
+    cout.unsetf(ios::floatfield);
+    return true;
+}
+
+// The stream versions return false if the stream fails, as writeFile() does
+bool CirMgr::writeAag(ostream& outfile) const {
+    CirWriteBuf buf(outfile);
+    writeAag(buf);
+    buf.flush();
+    return !buf.fail();
+}
+
+bool CirMgr::writeAig(ostream& outfile) const {
+    CirWriteBuf buf(outfile);
+    writeAig(buf);
+    buf.flush();
+    return !buf.fail();
+}
+
+bool CirMgr::writeGate(ostream& outfile, CirGate* g) const {
+    CirWriteBuf buf(outfile);
+    writeGate(buf, g);
+    buf.flush();
+    return !buf.fail();
+}
+
+bool CirMgr::writeBlif(const string& fileName) const {
+    return writeFile(fileName, BLIF);
+}
+
+/*************************************************/
+/*   Private member functions about the writers  */
+/*************************************************/
+// Gate IDs are the AAG variables; M is the largest ID written
+void CirMgr::writeAag(CirWriteBuf& buf) const {
+    size_t nAig = 0;
+    unsigned maxVar = 0;
+    for (unsigned i = 0, n = getNumPIs(); i < n; ++i)
+        maxVar = max(maxVar, getPi(i)->getGid());
+    for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i)
+        maxVar = max(maxVar, getRo(i)->getGid());
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        const CirGate* g = _dfsList[i];
+        if (g->isAig()) {
+            ++nAig;
+            maxVar = max(maxVar, g->getGid());
+            maxVar = max(maxVar, g->getIn1Gate()->getGid());  // e.g. undefined
+        }
+        if (g->isAig() || g->isPo() || g->getType() == RI_GATE)
+            maxVar = max(maxVar, g->getIn0Gate()->getGid());
+    }
+    buf << "aag " << maxVar << ' ' << getNumPIs() << ' ' << getNumLATCHs() << ' '
+        << getNumPOs() << ' ' << nAig << '\n';
+    for (unsigned i = 0, n = getNumPIs(); i < n; ++i)
+        buf << getPi(i)->getGid() * 2 << '\n';
+    for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i)
+        buf << getRo(i)->getGid() * 2 << ' ' << getRi(i)->getIn0().litId() << '\n';
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i)
+        buf << getPo(i)->getIn0().litId() << '\n';
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        const CirGate* g = _dfsList[i];
+        if (!g->isAig()) continue;
+        buf << g->getGid() * 2 << ' ' << g->getIn0().litId() << ' '
+            << g->getIn1().litId() << '\n';
+    }
+    for (unsigned i = 0, n = getNumPIs(); i < n; ++i)
+        if (const char* name = getName(getPi(i)->getGid()))
+            buf << 'i' << i << ' ' << name << '\n';
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i)
+        if (const char* name = getName(getPo(i)->getGid()))
+            buf << 'o' << i << ' ' << name << '\n';
+    buf << "c\nAAG output by Chung-Yang (Ric) Huang\n";
+}
+
+/**
+ * Binary AIGER: only the gates in the DFS list are written. The AIGER
+ * variables are renumbered as PIs, latches, then the AND gates in DFS
+ * order, so every AND gate is written after its fanins as the binary
+ * format requires. Undefined gates are written as const 0.
+ */
+void CirMgr::writeAig(CirWriteBuf& buf) const {
+    const unsigned nPIs = getNumPIs(), nLatches = getNumLATCHs();
+    IdList var(getNumTots(), 0);  // gate ID -> AIGER variable
+    unsigned nVars = 0;
+    for (unsigned i = 0; i < nPIs; ++i) var[getPi(i)->getGid()] = ++nVars;
+    for (unsigned i = 0; i < nLatches; ++i) var[getRo(i)->getGid()] = ++nVars;
+    const unsigned andBegin = nVars + 1;
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i)
+        if (_dfsList[i]->isAig()) var[_dfsList[i]->getGid()] = ++nVars;
+#define AIG_LIT(v) ((var[(v).gate()->getGid()] << 1) | ((v).isInv() ? 1 : 0))
+
+    buf << "aig " << nVars << ' ' << nPIs << ' ' << nLatches << ' '
+        << getNumPOs() << ' ' << (nVars - andBegin + 1) << '\n';
+    for (unsigned i = 0; i < nLatches; ++i)
+        buf << AIG_LIT(getRi(i)->getIn0()) << '\n';
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i)
+        buf << AIG_LIT(getPo(i)->getIn0()) << '\n';
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        const CirGate* g = _dfsList[i];
+        if (!g->isAig()) continue;
+        unsigned lhs = var[g->getGid()] << 1;
+        unsigned r0 = AIG_LIT(g->getIn0()), r1 = AIG_LIT(g->getIn1());
+        if (r0 < r1) swap(r0, r1);
+        assert(lhs > r0);
+        putDelta(buf, lhs - r0);
+        putDelta(buf, r0 - r1);
+    }
+#undef AIG_LIT
+    for (unsigned i = 0; i < nPIs; ++i)
+        if (const char* name = getName(getPi(i)->getGid()))
+            buf << 'i' << i << ' ' << name << '\n';
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i)
+        if (const char* name = getName(getPo(i)->getGid()))
+            buf << 'o' << i << ' ' << name << '\n';
+    buf << "c\nAIG output by GV\n";
+}
+
+// The fanin cone of g as a single-output AAG
+void CirMgr::writeGate(CirWriteBuf& buf, CirGate* g) const {
+    GateList faninCone;
+    CirGate::setGlobalRef();
+    g->genDfsList(faninCone);
+
+    size_t nAig = 0, npi = 0;
+    unsigned maxId = 0;
+    for (size_t i = 0, n = faninCone.size(); i < n; ++i) {
+        if (faninCone[i]->isAig()) ++nAig;
+        else if (faninCone[i]->isPi()) ++npi;
+        if (faninCone[i]->getGid() > maxId) maxId = faninCone[i]->getGid();
+    }
+    buf << "aag " << maxId << ' ' << npi << " 0 1 " << nAig << '\n';
+    for (unsigned i = 0, n = getNumPIs(); i < n; ++i)
+        if (getPi(i)->isGlobalRef())
+            buf << getPi(i)->getGid() * 2 << '\n';
+    buf << g->getGid() * 2 << '\n';
+    for (size_t i = 0, n = faninCone.size(); i < n; ++i) {
+        const CirGate* f = faninCone[i];
+        if (!f->isAig()) continue;
+        buf << f->getGid() * 2 << ' ' << f->getIn0().litId() << ' '
+            << f->getIn1().litId() << '\n';
+    }
+    for (unsigned i = 0, n = getNumPIs(), j = 0; i < n; ++i)
+        if (getPi(i)->isGlobalRef() && getName(getPi(i)->getGid()))
+            buf << 'i' << j++ << ' ' << getName(getPi(i)->getGid()) << '\n';
+    buf << "o0 " << g->getGid() << '\n';
+    buf << "c\nWrite gate (" << g->getGid() << ") by Chung-Yang (Ric) Huang\n";
+}
+
+/**
+ * BLIF of the AIG, written natively (no ABC/Yosys round trip): one .names
+ * per AND gate, a buffer or an inverter per PO and RI, and one .latch
+ * (reset to 0) per latch. Internal nets are "<prefix><gate ID>", where the
+ * prefix ("n", extended by '_' as needed) starts no PI/RO/PO name, so they
+ * never clash with the named nets. An unnamed PO is "<prefix>o<index>"; so
+ * is a PO whose name is taken by a PI, an RO or an earlier PO.
+ */
+void CirMgr::writeBlif(CirWriteBuf& buf, const string& fileName) const {
+    string model = fileName;
+    size_t pos   = model.find_last_of('/');
+    if (pos != string::npos) model = model.substr(pos + 1);
+    pos = model.find('.');
+    if (pos != string::npos && pos) model = model.substr(0, pos);
+
+    vector<string> names;  // PI/RO names, then PO names
+    for (unsigned i = 0, n = getNumPIs(); i < n; ++i)
+        if (const char* name = getName(getPi(i)->getGid())) names.push_back(name);
+    for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i)
+        if (const char* name = getName(getRo(i)->getGid())) names.push_back(name);
+    const size_t nInNames = names.size();
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i)
+        if (const char* name = getName(getPo(i)->getGid())) names.push_back(name);
+    string prefix = "n";
+    for (bool clash = true; clash; ) {
+        clash = false;
+        for (size_t i = 0, n = names.size(); i < n && !clash; ++i)
+            clash = names[i].compare(0, prefix.size(), prefix) == 0;
+        if (clash) prefix += '_';
+    }
+
+    buf << ".model " << (model.empty() ? string("top") : model) << '\n';
+    buf << ".inputs";
+    for (unsigned i = 0, n = getNumPIs(); i < n; ++i)
+        buf << ((i % 8 == 7) ? " \\\n " : " ") << blifNet(this, getPi(i), prefix);
+    buf << "\n.outputs";
+    set<string> taken(names.begin(), names.begin() + nInNames);
+    vector<string> poNames(getNumPOs());
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i) {
+        const char* name = getName(getPo(i)->getGid());
+        if (name && taken.insert(name).second) poNames[i] = name;
+        else {
+            if (name)
+                cerr << "Warning: PO " << i << " (" << name
+                     << ") is renamed in the BLIF file; the name is taken!!"
+                     << endl;
+            poNames[i] = prefix + "o" + to_string(i);
+        }
+        buf << ((i % 8 == 7) ? " \\\n " : " ") << poNames[i];
+    }
+    buf << '\n';
+    for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i)
+        buf << ".latch " << prefix << getRi(i)->getGid() << ' '
+            << blifNet(this, getRo(i), prefix) << " 0\n";
+    buf << ".names " << blifNet(this, _const0, prefix) << '\n';  // const 0 (no cube)
+
+    for (size_t i = 0, n = _dfsList.size(); i < n; ++i) {
+        const CirGate* g = _dfsList[i];
+        if (!g->isAig()) continue;
+        const CirGateV in0 = g->getIn0(), in1 = g->getIn1();
+        buf << ".names " << blifNet(this, in0.gate(), prefix) << ' '
+            << blifNet(this, in1.gate(), prefix) << ' ' << blifNet(this, g, prefix)
+            << '\n' << (in0.isInv() ? '0' : '1') << (in1.isInv() ? '0' : '1') << " 1\n";
+    }
+    for (unsigned i = 0, n = getNumPOs(); i < n; ++i)
+        writeBlifBuf(buf, this, getPo(i)->getIn0(), poNames[i], prefix);
+    for (unsigned i = 0, n = getNumLATCHs(); i < n; ++i)
+        writeBlifBuf(buf, this, getRi(i)->getIn0(),
+                     prefix + to_string(getRi(i)->getGid()), prefix);
+    buf << ".end\n";
+}
@@ -61,13 +61,14 @@ SATVerifyItpCmd::exec(const string& option) {
             return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[1]);
         }
         gate        = cirMgr->getPo(num);
-        monitorName = gate->getName();
+        monitorName = cirMgr->getName(gate->getGid());
     }
     // get PO's input, since the PO is actually a redundant node and should be removed
-    CirGate* monitor = new CirAigGate(cirMgr->getNumTots(), 0);
+    CirGate* monitor = new CirAigGate(cirMgr->getNumTots());
     cirMgr->addTotGate(monitor);
     monitor->setIn0(gate->getIn0Gate(), gate->getIn0().isInv());
-    monitor->setIn1(cirMgr->_const1, false);
+    monitor->setIn1(cirMgr->_const0, true);  // const 1
+    cirMgr->addDfsGate(monitor);
     satMgr->verifyPropertyItp(monitorName, monitor);
 
     return GV_CMD_EXEC_DONE;
@@ -117,7 +118,7 @@ SATVerifyBmcCmd::exec(const string& option) {
             gvMsg(GV_MSG_ERR) << "Output with Index " << num << " does NOT Exist in Current Cir !!" << endl;
             return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[1]);
         }
-        monitorName = cirMgr->getPo(num)->getName();
+        monitorName = cirMgr->getName(cirMgr->getPo(num)->getGid());
         gate        = cirMgr->getPo(num)->getIn0Gate();
     }
     // get PO's input, since the PO is actually a redundant node and should be removed
@@ -72,7 +72,7 @@ void SATMgr::indBmc(const CirGate *monitor, SatProofRes &pRes) {
 
     uint32_t i = 0;
     // GVNetId  I = buildInitState();
-    CirGate *I = buildInitState();
+    CirGateV I = buildInitState();
     gvSatSolver->addBoundedVerifyData(I, i);
     gvSatSolver->assertProperty(I, false, i);
     // Start Bounded Model Checking
@@ -99,17 +99,17 @@ void SATMgr::itpUbmc(const CirGate *monitor, SatProofRes &pRes) {
     bool proved        = false;
     gvSatSolver->assumeRelease();
     // GVNetId S, R, R_prime, tmp1, tmp2, tmp3, tmp4;
-    CirGate *S;
-    CirGate *R;
-    CirGate *R_prime;
-    CirGate *isfixed;
+    CirGateV S;
+    CirGateV R;
+    CirGateV R_prime;
+    CirGateV isfixed;
 
     // TODO : finish your own Interpolation-based property checking
 
 
     // PART I:
     // Build Initial State
-    CirGate *I = buildInitState();
+    CirGateV I = buildInitState();
     // PART II:
     // Take care the first timeframe (i.e. Timeframe 0 )
     //    Check if monitor is violated at timeframe 0
@@ -258,7 +258,7 @@ void SATMgr::markOffsetClause(const ClauseId &cid) {
 
 void SATMgr::mapVar2Net(const Var &var, CirGate *net) { _var2Net[var] = net; }
 
-CirGate *SATMgr::getItp() const {
+CirGateV SATMgr::getItp() const {
     assert(_ptrMinisat);
     assert(_ptrMinisat->_solver->proof);
 
@@ -275,7 +275,7 @@ CirGate *SATMgr::getItp() const {
 
     // bulding ITP
     // GVNetId netId = buildItp(proofName);
-    CirGate *gateId = buildItp(proofName);
+    CirGateV gateId = buildItp(proofName);
 
     // delete proof log
     unlink(proofName.c_str());
@@ -482,16 +482,15 @@ void SATMgr::retrieveProof(Reader &rdr, vector<unsigned int> &clausePos, vector<
     }
 }
 
-CirGate *SATMgr::buildInitState() const {
+CirGateV SATMgr::buildInitState() const {
     // TODO: build initial state
     // CirAigGate *I;
     // _cirMgr->writeGate(cout, _cirMgr->_const0);
     // for(unsigned i = 0; i < _cirMgr->getNumPIs(); ++i){
     //     cout << "PI: " << _cirMgr->getPi(i)->getGid() << endl;}
-    CirGate *I;
-    I = _cirMgr->createAndGate(_cirMgr->createNotGate(_cirMgr->getRo(0)), _cirMgr->createNotGate(_cirMgr->getRo(1)));
-    for(unsigned i = 2, j = _cirMgr->getNumLATCHs(); i<j; ++i){
-        CirGate* invRegOut = _cirMgr->createNotGate(_cirMgr->getRo(i));
+    CirGateV I(_cirMgr->_const0, true);  // const 1
+    for(unsigned i = 0, j = _cirMgr->getNumLATCHs(); i<j; ++i){
+        CirGateV invRegOut = _cirMgr->createNotGate(CirGateV(_cirMgr->getRo(i), false));
         I = _cirMgr->createAndGate(I, invRegOut);
     }
     // cout<<I->getGid()<<endl;
@@ -559,22 +558,22 @@ CirGate *SATMgr::buildInitState() const {
 }
 
 // build the McMillan Interpolant
-CirGate *SATMgr::buildItp(const string &proofName) const {
+CirGateV SATMgr::buildItp(const string &proofName) const {
     Reader rdr;
     // records
-    map<ClauseId, CirGate *> claItpLookup;
+    map<ClauseId, CirGateV> claItpLookup;
     vector<unsigned int> clausePos;
     vector<ClauseId> usedClause;
     // ntk
     uint32_t netSize = _cirMgr->getNumTots();
     // temperate variables
-    CirGate *nId;
-    CirGate *nId1;
-    CirGate *nId2;
+    CirGateV nId;
+    CirGateV nId1;
+    CirGateV nId2;
     int i, cid, tmp, idx, tmp_cid;
     // const 1 & const 0
-    CirGate *CONST0 = _cirMgr->_const0;
-    CirGate *CONST1 = _cirMgr->_const1;
+    CirGateV CONST0(_cirMgr->_const0, false);
+    CirGateV CONST1(_cirMgr->_const0, true);
 
     rdr.open(proofName.c_str());
     retrieveProof(rdr, clausePos, usedClause);
@@ -595,8 +594,8 @@ CirGate *SATMgr::buildItp(const string &proofName) const {
                 if (_varGroup[idx >> 1] == COMMON) {
                     // cout<<"finding: "<<(idx>>1)<<endl;
                     assert(_var2Net.find(idx >> 1) != _var2Net.end());
-                    nId  = (_var2Net.find(idx >> 1))->second;
-                    nId1 = (_var2Net.find(idx >> 1))->second;
+                    nId  = CirGateV((_var2Net.find(idx >> 1))->second, false);
+                    nId1 = CirGateV((_var2Net.find(idx >> 1))->second, false);
                     if ((idx & 1) == 1) nId1 = _cirMgr->createNotGate(nId1);
                     if ((idx & 1) == 1) nId = _cirMgr->createNotGate(nId);
                     while (1) {
@@ -605,7 +604,7 @@ CirGate *SATMgr::buildItp(const string &proofName) const {
                         idx += tmp;
                         if (_varGroup[idx >> 1] == COMMON) {
                             assert(_var2Net.find(idx >> 1) != _var2Net.end());
-                            nId2 = (_var2Net.find(idx >> 1))->second;
+                            nId2 = CirGateV((_var2Net.find(idx >> 1))->second, false);
                             if ((idx & 1) == 1) nId2 = _cirMgr->createNotGate(nId2);
                             nId  = _cirMgr->createOrGate(nId1, nId2);
                             nId1 = nId;
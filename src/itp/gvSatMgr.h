@@ -82,7 +82,7 @@ public:
     void mapVar2Net(const Var& var, CirGate* net);
     // please be sure that you call these function right after a UNSAT solving
     // GVNetId        getItp() const;
-    CirGate* getItp() const;
+    CirGateV getItp() const;
     vector<Clause> getUNSATCore() const;
     // get number of clauses (the latest clause id + 1)
     int getNumClauses() const { return _ptrMinisat->getNumClauses(); }
@@ -95,9 +95,9 @@ public:
 private:
     // helper functions to get proof info.
     // GVNetId buildInitState() const;
-    CirGate* buildInitState() const;
+    CirGateV buildInitState() const;
     // GVNetId buildItp(const string& proofName) const;
-    CirGate* buildItp(const string& proofName) const;
+    CirGateV buildItp(const string& proofName) const;
     void retrieveProof(Reader& rdr, vector<unsigned>& clausePos, vector<ClauseId>& usedClause) const;
     void retrieveProof(Reader& rdr, vector<Clause>& unsatCore) const;
 
@@ -75,11 +75,14 @@ BddMgrV::buildPImage(int level) {
     _isFixed = false;
     for(int l = 0; l < level && !isPFixed(); ++l){
         BddNodeV S_n_X = getPReachState();
-        // if(_reachStates.size() > 1){
-        //     S_n_X = restrict(getPReachState(), ~(_reachStates[_reachStates.size()-2]));
-        // }
+        // Only the frontier (newly reached states) needs to be imaged;
+        // states reached before are don't cares
+        if(_reachStates.size() > 1){
+            S_n_X = restrict(getPReachState(), ~(_reachStates[_reachStates.size()-2]));
+        }
         // cout << "S_n_X" << endl << S_n_X << endl;
-        S_n_X = S_n_X & getPTr();
+        // TR only matters inside S_n_X ==> minimize it with S_n_X as care set
+        S_n_X = S_n_X & restrict(getPTr(), S_n_X);
         BddNodeV S_nxt_YX  = S_n_X;
         // ofstream fout1("S_n+1_YX.dot");
         // S_nxt_YX.drawBdd("S_n+1_YX",fout1);
@@ -118,6 +121,7 @@ BddMgrV::buildPImage(int level) {
             cout << "Fixed point is reached (time : " << _reachStates.size() -1 << ")" << endl;
         }
         else _reachStates.push_back(S_nxt_YX);
+        if (_statsLog) writeStatsRow(*_statsLog, _reachStates.size() - 1);
         // cout << "after: S_nxt_YX" << endl << S_nxt_YX << endl;
         
         // cout << l << endl;
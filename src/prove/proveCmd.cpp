@@ -9,6 +9,7 @@
 #include "proveCmd.h"
 
 #include <cstring>
+#include <fstream>
 #include <iomanip>
 
 #include "bddMgrV.h"
@@ -116,7 +117,8 @@ void PTransRelationCmd::help() const {
 }
 
 //----------------------------------------------------------------------
-//    PIMAGe [-Next <(int numTimeframes)>] [(string varName)]
+//    PIMAGe [-Next <(int numTimeframes)>] [-Stats <(string csvFile)>]
+//           [(string varName)]
 //----------------------------------------------------------------------
 GVCmdExecStatus
 PImageCmd::exec(const string& option) {
@@ -131,7 +133,7 @@ PImageCmd::exec(const string& option) {
     }
 
     int level = 1;
-    string name;
+    string name, statsFile;
     vector<string> options;
     GVCmdExec::lexOptions(option, options);
 
@@ -144,21 +146,36 @@ PImageCmd::exec(const string& option) {
             } else
                 return GVCmdExec::errorOption(GV_CMD_OPT_MISSING,
                                               options[i - 1]);
+        else if (!myStrNCmp("-Stats", options[i], 2))
+            if (++i < n) statsFile = options[i];
+            else
+                return GVCmdExec::errorOption(GV_CMD_OPT_MISSING,
+                                              options[i - 1]);
         else if (name.empty()) {
             name = options[i];
             if (!isValidVarName(name))
                 return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, name);
         } else return GVCmdExec::errorOption(GV_CMD_OPT_ILLEGAL, options[i]);
+
+    // one CSV row of BDD statistics per image iteration
+    ofstream statsLog;
+    if (!statsFile.empty()) {
+        statsLog.open(statsFile.c_str());
+        if (!statsLog)
+            return GVCmdExec::errorOption(GV_CMD_OPT_FOPEN_FAIL, statsFile);
+        bddMgrV->writeStatsHeader(statsLog);
+        bddMgrV->setStatsLog(&statsLog);
+    }
     bddMgrV->buildPImage(level);
+    bddMgrV->setStatsLog(0);
     if (!name.empty())
         bddMgrV->forceAddBddNodeV(name, bddMgrV->getPReachState()());
     return GV_CMD_EXEC_DONE;
 }
 
 void PImageCmd::usage(const bool& verbose) const {
-    cout
-        << "Usage: PIMAGe [-Next <(int numTimeframes)>] [(string varName)]"
-        << endl;
+    cout << "Usage: PIMAGe [-Next <(int numTimeframes)>] "
+         << "[-Stats <(string csvFile)>] [(string varName)]" << endl;
 }
 
 void PImageCmd::help() const {
@@ -215,7 +232,7 @@ PCheckPropertyCmd::exec(const string& option) {
     assert(monitor());
     // bddMgrV->runPCheckProperty(gvNtkMgr->getNetNameFromId(netId.id), monitor);
     string mStr = "monitor";
-    bddMgrV->runPCheckProperty(cirMgr->getPo(num)->getName(), monitor);
+    bddMgrV->runPCheckProperty(cirMgr->getName(cirMgr->getPo(num)->getGid()), monitor);
 
     return GV_CMD_EXEC_DONE;
 }
@@ -149,6 +149,8 @@ class SolverV
             // vec<Lit> dummy(2,gv_lit_Undef);
             // propagate_tmpbin = Clause_new(false, dummy);
             // analyze_tmpbin   = Clause_new(false, dummy);
+            propagate_tmpbin = NULL;  // not used; freed by ~SolverV()
+            analyze_tmpbin   = NULL;
             addUnit_tmp.growTo(1);
             addBinary_tmp.growTo(2);
             addTernary_tmp.growTo(3);
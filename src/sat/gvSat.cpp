@@ -69,6 +69,14 @@ void GVSatSolver::assertProperty(const CirGate* gate, const bool& invert, const
     _solver->addUnit(mkLit(var, invert));
 }
 
+void GVSatSolver::assumeProperty(const CirGateV& gateV, const bool& invert, const uint32_t& depth) {
+    assumeProperty(gateV.gate(), invert ^ gateV.isInv(), depth);
+}
+
+void GVSatSolver::assertProperty(const CirGateV& gateV, const bool& invert, const uint32_t& depth) {
+    assertProperty(gateV.gate(), invert ^ gateV.isInv(), depth);
+}
+
 const bool
 GVSatSolver::simplify() {
     return _solver->simplifyDB();
@@ -220,6 +228,10 @@ void GVSatSolver::addBoundedVerifyData(const CirGate* gate, const uint32_t& dept
     addBoundedVerifyDataRecursively(gate, depth);
 }
 
+void GVSatSolver::addBoundedVerifyData(const CirGateV& gateV, const uint32_t& depth) {
+    addBoundedVerifyData(gateV.gate(), depth);
+}
+
 void GVSatSolver::addBoundedVerifyDataRecursively(const CirGate* gate, const uint32_t& depth) {
     GateType type = gate->getType();
     if (existVerifyData(gate, depth)) return;
@@ -36,6 +36,9 @@ public:
     void assertProperty(const size_t&, const bool&);
     void assumeProperty(const CirGate* gate, const bool& invert, const uint32_t& depth);
     void assertProperty(const CirGate* gate, const bool& invert, const uint32_t& depth);
+    // for literals returned by CirMgr::create*Gate()
+    void assumeProperty(const CirGateV& gateV, const bool& invert, const uint32_t& depth);
+    void assertProperty(const CirGateV& gateV, const bool& invert, const uint32_t& depth);
     const bool simplify();
     const bool solve();
     const bool assump_solve();
@@ -57,6 +60,7 @@ public:
     void add_AND_Formula(const CirGate*, const uint32_t&);
 
     void addBoundedVerifyData(const CirGate*, const uint32_t&);
+    void addBoundedVerifyData(const CirGateV&, const uint32_t&);
     const bool existVerifyData(const CirGate*, const uint32_t&);
     void resizeNtkData(const uint32_t& num);
     void IteratentkData(){